@@ -12,159 +12,536 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <list>
-#include <unordered_map>
+#include <new>
+#include <vector>
 
 namespace bustub {
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
+/**
+ * Map an arena for size bytes of frames. Mappings are aligned to the OS page size, which is a multiple of the alignment
+ * of Page, so every frame in the arena is aligned.
+ */
+static void *MapFrameArena(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+#ifdef MAP_HUGETLB
+  // Explicit huge pages need pages reserved by the administrator, fall back to transparent huge pages without them.
+  if (enable_huge_pages) {
+    void *arena = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (arena != MAP_FAILED) {
+      return arena;
+    }
+  }
+#endif
+  void *arena = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (arena == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+#ifdef MADV_HUGEPAGE
+  if (enable_huge_pages) {
+    madvise(arena, size, MADV_HUGEPAGE);
+  }
+#endif
+  return arena;
+}
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager,
+                                     ReplacerType replacer_type)
+    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager), page_table_(pool_size) {
   // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
+  frame_arena_ = MapFrameArena(pool_size_ * sizeof(Page));
+  pages_ = static_cast<Page *>(frame_arena_);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (&pages_[i]) Page();
+  }
+  switch (replacer_type) {
+    case ReplacerType::CLOCK:
+      replacer_ = new ClockReplacer(pool_size);
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size);
+      break;
+    case ReplacerType::LRU:
+    default:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].pin_count_ = FRAME_CLAIMED;
     free_list_.emplace_back(static_cast<int>(i));
   }
 }
 
 BufferPoolManager::~BufferPoolManager() {
-  delete[] pages_;
+  if (prefetch_thread_ != nullptr) {
+    {
+      std::lock_guard<std::mutex> guard(prefetch_latch_);
+      prefetch_running_ = false;
+    }
+    prefetch_cv_.notify_one();
+    prefetch_thread_->join();
+    delete prefetch_thread_;
+  }
+  StopBackgroundFlusher();
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  if (frame_arena_ != nullptr) {
+    munmap(frame_arena_, pool_size_ * sizeof(Page));
+  }
   delete replacer_;
 }
 
-Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
-  std::lock_guard<std::mutex> guard(this->latch_);
+Page *BufferPoolManager::FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
   frame_id_t frame_id;
   // 1.     Search the page table for the requested page (P).
-  if (page_table_.find(page_id) != page_table_.end()) {
-    // 1.1    If P exists, pin it and return it immediately.
-    frame_id = page_table_[page_id];
-    replacer_->Pin(frame_id);
-    pages_[frame_id].pin_count_++;
+  // 1.1    If P exists, pin it and return it immediately. The hit path takes no latch.
+  if (page_table_.Find(page_id, &frame_id) && TryPinFrame(frame_id, page_id)) {
     return &pages_[frame_id];
   }
 
-  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
-
-  if (!free_list_.empty()) {
-    // Note that pages are always found from the free list first.
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else {
-    if (!replacer_->Victim(&frame_id)) {
-      return nullptr;
+  std::unique_lock<std::mutex> lock(this->latch_);
+  // The lock-free lookup may have raced with a writer, look again now that the page table is stable. Only LoadPages
+  // leaves a claimed frame in the page table when it lets go of latch_, while it reads the page: wait for the read
+  // instead of reading the page a second time.
+  while (page_table_.Find(page_id, &frame_id)) {
+    if (pages_[frame_id].pin_count_.load() != FRAME_CLAIMED) {
+      pages_[frame_id].pin_count_.fetch_add(1);
+      return &pages_[frame_id];
     }
-    // 2.     If R is dirty, write it back to the disk.
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-      pages_[frame_id].is_dirty_ = false;
-    }
-    // 3.     Delete R from the page table and insert P.
-    page_table_.erase(pages_[frame_id].page_id_);
+    load_cv_.wait(lock);
+  }
+
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer. A sequential
+  //        scan recycles the frames of its ring first.
+  // 2.     If R is dirty, write it back to the disk.
+  // 3.     Delete R from the page table and insert P.
+  bool found = strategy != nullptr && ReuseRingFrame(strategy, &frame_id);
+  if (!found && !FindVictimFrame(&frame_id)) {
+    return nullptr;
+  }
+  if (strategy != nullptr) {
+    strategy->AddPage(page_id);
   }
 
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  page_table_[page_id] = frame_id;
-  pages_[frame_id].page_id_ = page_id;
-  pages_[frame_id].pin_count_++;
-  pages_[frame_id].is_dirty_ = false;
-  pages_[frame_id].ResetMemory();
-  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+  // The frame stays FRAME_CLAIMED until the content is read, so a stale hit cannot pin a half-read page.
+  Page *page = &pages_[frame_id];
+  page->ResetMemory();
+  disk_manager_->ReadPage(page_id, page->GetData());
+  page->is_dirty_ = false;
+  page->page_id_ = page_id;
+  page->EndModification();
+  page->pin_count_.store(1, std::memory_order_release);
+  page_table_.Insert(page_id, frame_id);
+  return page;
+}
+
+Page *BufferPoolManager::PeekPage(page_id_t page_id) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return nullptr;
+  }
   return &pages_[frame_id];
 }
 
 bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
-  std::lock_guard<std::mutex> guard(this->latch_);
   frame_id_t frame_id;
-  assert(page_table_.find(page_id) != page_table_.end());
-  frame_id = page_table_[page_id];
+  // The caller holds a pin, so the page cannot leave the page table. A miss only means the lock-free lookup raced
+  // with a writer moving entries around.
+  if (!page_table_.Find(page_id, &frame_id)) {
+    std::lock_guard<std::mutex> guard(this->latch_);
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
+  }
   if (is_dirty) {
     pages_[frame_id].is_dirty_ = true;
   }
-  pages_[frame_id].pin_count_--;
-  assert(pages_[frame_id].pin_count_ >= 0);
-  if (pages_[frame_id].pin_count_ == 0) {
-    replacer_->Unpin(frame_id);
-  }
-  return true;
+  return UnpinFrame(frame_id);
 }
 
 bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
   std::lock_guard<std::mutex> guard(this->latch_);
   // Make sure you call DiskManager::WritePage!
-  assert(page_table_.find(page_id) != page_table_.end());
-  disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].GetData());
-  pages_[page_table_[page_id]].is_dirty_ = false;
+  frame_id_t frame_id;
+  // A page that LoadPages is still reading is clean, and its frame does not hold it yet.
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].pin_count_.load() == FRAME_CLAIMED) {
+    return false;
+  }
+  pages_[frame_id].is_dirty_ = false;
+  disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
   return true;
 }
 
 Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
-  std::lock_guard<std::mutex> guard(this->latch_);
+  std::unique_lock<std::mutex> lock(this->latch_);
   // 0.   Make sure you call DiskManager::AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   frame_id_t frame_id;
+  if (!FindVictimFrame(&frame_id)) {
+    return nullptr;
+  }
+
+  *page_id = disk_manager_->AllocatePage();
+  DropStaleCopy(*page_id, &lock);
+  // 3.   Update P's metadata, zero out memory and add P to the page table.
+  // 4.   Set the page ID output parameter. Return a pointer to P.
+  return InitNewPage(frame_id, *page_id);
+}
+
+Page *BufferPoolManager::NewPageWithIdImpl(page_id_t page_id) {
+  std::unique_lock<std::mutex> lock(this->latch_);
+  DropStaleCopy(page_id, &lock);
+  frame_id_t frame_id;
+  if (!FindVictimFrame(&frame_id)) {
+    return nullptr;
+  }
+  return InitNewPage(frame_id, page_id);
+}
+
+bool BufferPoolManager::FindVictimFrame(frame_id_t *frame_id) {
   if (!free_list_.empty()) {
-    frame_id = free_list_.front();
+    *frame_id = free_list_.front();
     free_list_.pop_front();
-  } else {
-    if (!replacer_->Victim(&frame_id)) {
-      return nullptr;
+    pages_[*frame_id].BeginModification();
+    return true;
+  }
+  // Hits do not remove frames from the replacer, so a victim may have been pinned again since it was unpinned. Such a
+  // frame is dropped from the replacer here, and goes back in with its access history when its pin count drops to zero
+  // again. Only a frame that is actually evicted is removed from the replacer.
+  while (replacer_->Victim(frame_id)) {
+    Page *victim = &pages_[*frame_id];
+    int unpinned = 0;
+    if (victim->pin_count_.compare_exchange_strong(unpinned, FRAME_CLAIMED)) {
+      replacer_->Remove(*frame_id);
+      EvictFrame(*frame_id);
+      return true;
     }
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(pages_[frame_id].page_id_, pages_[frame_id].GetData());
-      pages_[frame_id].is_dirty_ = false;
+  }
+  return false;
+}
+
+bool BufferPoolManager::ReuseRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id) {
+  // Until the ring is full, the scan takes its frames from the free list or the replacer like any other miss.
+  // Pages of the ring may have been evicted by others since, or belong to another instance of a parallel pool.
+  std::lock_guard<std::mutex> guard(strategy->latch_);
+  if (strategy->ring_.size() < strategy->ring_size_) {
+    return false;
+  }
+  for (auto iter = strategy->ring_.begin(); iter != strategy->ring_.end(); ++iter) {
+    if (!page_table_.Find(*iter, frame_id)) {
+      continue;
+    }
+    int unpinned = 0;
+    if (pages_[*frame_id].pin_count_.compare_exchange_strong(unpinned, FRAME_CLAIMED)) {
+      replacer_->Remove(*frame_id);
+      EvictFrame(*frame_id);
+      strategy->ring_.erase(iter);
+      return true;
     }
-    page_table_.erase(pages_[frame_id].page_id_);
   }
+  return false;
+}
 
-  *page_id = disk_manager_->AllocatePage();
-  // 3.   Update P's metadata, zero out memory and add P to the page table.
-  pages_[frame_id].ResetMemory();
-  pages_[frame_id].page_id_ = *page_id;
-  pages_[frame_id].pin_count_ = 1;
+void BufferPoolManager::EvictFrame(frame_id_t frame_id) {
+  Page *victim = &pages_[frame_id];
+  victim->BeginModification();
+  page_table_.Remove(victim->page_id_);
+  if (victim->IsDirty()) {
+    disk_manager_->WritePage(victim->page_id_, victim->GetData());
+    victim->is_dirty_ = false;
+    // The background flusher is falling behind.
+    if (flusher_running_) {
+      flusher_cv_.notify_one();
+    }
+  }
+  victim->page_id_ = INVALID_PAGE_ID;
+}
+
+void BufferPoolManager::DropStaleCopy(page_id_t page_id, std::unique_lock<std::mutex> *lock) {
+  frame_id_t frame_id;
+  while (page_table_.Find(page_id, &frame_id) && pages_[frame_id].pin_count_.load() == FRAME_CLAIMED) {
+    load_cv_.wait(*lock);
+  }
+  int unpinned = 0;
+  if (!page_table_.Find(page_id, &frame_id) ||
+      !pages_[frame_id].pin_count_.compare_exchange_strong(unpinned, FRAME_CLAIMED)) {
+    return;
+  }
+  pages_[frame_id].BeginModification();
+  replacer_->Remove(frame_id);
+  page_table_.Remove(page_id);
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
   pages_[frame_id].is_dirty_ = false;
-  page_table_[*page_id] = frame_id;
-  replacer_->Pin(frame_id);
-  // 4.   Set the page ID output parameter. Return a pointer to P.
-  return &pages_[frame_id];
+  pages_[frame_id].EndModification();
+  free_list_.push_back(frame_id);
+}
+
+Page *BufferPoolManager::InitNewPage(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = &pages_[frame_id];
+  page->ResetMemory();
+  page->is_dirty_ = false;
+  page->page_id_ = page_id;
+  page->EndModification();
+  page->pin_count_.store(1, std::memory_order_release);
+  page_table_.Insert(page_id, frame_id);
+  return page;
+}
+
+bool BufferPoolManager::TryPinFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_.load(std::memory_order_relaxed);
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1, std::memory_order_acquire));
+  // The frame may have been replaced between the page table lookup and the pin.
+  if (page->page_id_.load(std::memory_order_acquire) != page_id) {
+    UnpinFrame(frame_id);
+    return false;
+  }
+  return true;
+}
+
+bool BufferPoolManager::UnpinFrame(frame_id_t frame_id, bool record_access) {
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_.load(std::memory_order_relaxed);
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1, std::memory_order_release));
+  if (pin_count == 1) {
+    if (record_access) {
+      replacer_->RecordAccess(frame_id);
+    } else {
+      replacer_->Unpin(frame_id);
+    }
+  }
+  return true;
+}
+
+void BufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids,
+                                      std::shared_ptr<BufferAccessStrategy> strategy) {
+  if (page_ids.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(prefetch_latch_);
+  if (prefetch_thread_ == nullptr) {
+    prefetch_running_ = true;
+    prefetch_thread_ = new std::thread([this]() {
+      std::unique_lock<std::mutex> lock(prefetch_latch_);
+      while (true) {
+        prefetch_cv_.wait(lock, [this]() { return !prefetch_running_ || !prefetch_queue_.empty(); });
+        if (!prefetch_running_) {
+          return;
+        }
+        PrefetchRequest request = std::move(prefetch_queue_.front());
+        prefetch_queue_.pop_front();
+        lock.unlock();
+        LoadPages(request.page_ids_, request.strategy_.get());
+        lock.lock();
+      }
+    });
+  }
+  prefetch_queue_.push_back({page_ids, std::move(strategy)});
+  prefetch_cv_.notify_one();
+}
+
+page_id_t BufferPoolManager::ReadAhead(page_id_t page_id, page_id_t next_page_id, page_id_t window_end,
+                                       const std::shared_ptr<BufferAccessStrategy> &strategy) {
+  if (next_page_id == INVALID_PAGE_ID) {
+    return window_end;
+  }
+  bool in_window = window_end != INVALID_PAGE_ID && next_page_id < window_end &&
+                   next_page_id >= window_end - READ_AHEAD_PAGES;
+  if (in_window && next_page_id + READ_AHEAD_PAGES / 2 < window_end) {
+    return window_end;
+  }
+  page_id_t begin = in_window ? window_end : next_page_id;
+  page_id_t end = next_page_id == page_id + 1 ? next_page_id + READ_AHEAD_PAGES : next_page_id + 1;
+  if (begin >= end) {
+    return window_end;
+  }
+  std::vector<page_id_t> page_ids;
+  for (page_id_t prefetch_page_id = begin; prefetch_page_id < end; ++prefetch_page_id) {
+    page_ids.push_back(prefetch_page_id);
+  }
+  PrefetchPages(page_ids, strategy);
+  return end;
+}
+
+void BufferPoolManager::LoadPages(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy) {
+  std::vector<page_id_t> load_page_ids;
+  std::vector<frame_id_t> frame_ids;
+  std::vector<char *> page_data;
+  {
+    std::lock_guard<std::mutex> guard(this->latch_);
+    // Claim a frame for every allocated, non resident page, until we run out of frames. The page table points to the
+    // claimed frames right away, so that misses on these pages wait for the read instead of reading them again.
+    page_id_t num_pages = disk_manager_->GetNumPages();
+    for (page_id_t page_id : page_ids) {
+      frame_id_t frame_id;
+      if (page_id < 0 || page_id >= num_pages || page_table_.Find(page_id, &frame_id)) {
+        continue;
+      }
+      bool found = strategy != nullptr && ReuseRingFrame(strategy, &frame_id);
+      if (!found && !FindVictimFrame(&frame_id)) {
+        break;
+      }
+      page_table_.Insert(page_id, frame_id);
+      load_page_ids.push_back(page_id);
+      frame_ids.push_back(frame_id);
+      page_data.push_back(pages_[frame_id].GetData());
+    }
+  }
+  if (load_page_ids.empty()) {
+    return;
+  }
+
+  // The frames stay FRAME_CLAIMED, with an odd version, until their content is read. The disk manager reads each run
+  // of consecutive page ids with a single I/O, straight into the frames, and other misses go on meanwhile.
+  std::vector<bool> read = disk_manager_->ReadPages(load_page_ids, page_data);
+  {
+    std::lock_guard<std::mutex> guard(this->latch_);
+    for (size_t i = 0; i < frame_ids.size(); ++i) {
+      Page *page = &pages_[frame_ids[i]];
+      if (!read[i]) {
+        // Prefetching is only a hint, a page that could not be read is left for a later fetch to read again.
+        page_table_.Remove(load_page_ids[i]);
+        page->EndModification();
+        free_list_.push_back(frame_ids[i]);
+        continue;
+      }
+      page->is_dirty_ = false;
+      page->page_id_ = load_page_ids[i];
+      page->EndModification();
+      page->pin_count_.store(0, std::memory_order_release);
+      replacer_->Unpin(frame_ids[i]);
+      if (strategy != nullptr) {
+        strategy->AddPage(load_page_ids[i]);
+      }
+    }
+  }
+  load_cv_.notify_all();
+}
+
+void BufferPoolManager::RunBackgroundFlusher(double target_clean_ratio) {
+  StopBackgroundFlusher();
+  target_clean_ratio_ = target_clean_ratio;
+  flusher_running_ = true;
+  flusher_thread_ = new std::thread([this]() {
+    std::unique_lock<std::mutex> lock(flusher_latch_);
+    while (flusher_running_) {
+      lock.unlock();
+      CleanVictimFrames();
+      lock.lock();
+      if (flusher_running_) {
+        flusher_cv_.wait_for(lock, background_flush_interval);
+      }
+    }
+  });
+}
+
+void BufferPoolManager::StopBackgroundFlusher() {
+  if (flusher_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(flusher_latch_);
+    flusher_running_ = false;
+  }
+  flusher_cv_.notify_one();
+  flusher_thread_->join();
+  delete flusher_thread_;
+  flusher_thread_ = nullptr;
+}
+
+void BufferPoolManager::CleanVictimFrames() {
+  auto lookahead = static_cast<size_t>(std::ceil(target_clean_ratio_ * pool_size_));
+  lookahead = std::min(lookahead, replacer_->Size());
+  if (lookahead == 0) {
+    return;
+  }
+  std::vector<frame_id_t> frame_ids;
+  replacer_->PeekVictims(lookahead, &frame_ids);
+  for (frame_id_t frame_id : frame_ids) {
+    CleanFrame(frame_id);
+  }
+}
+
+void BufferPoolManager::CleanFrame(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  page_id_t page_id = page->page_id_.load(std::memory_order_acquire);
+  if (page_id == INVALID_PAGE_ID || !page->IsDirty() || !TryPinFrame(frame_id, page_id)) {
+    return;
+  }
+  // Clear the dirty flag before copying: a writer that modifies the page after the copy marks it dirty again when it
+  // unpins. The copy lets the write happen without holding the page latch.
+  if (page->is_dirty_.exchange(false)) {
+    alignas(PAGE_SIZE) char data[PAGE_SIZE];
+    page->RLatch();
+    memcpy(data, page->GetData(), PAGE_SIZE);
+    page->RUnlatch();
+    disk_manager_->WritePage(page_id, data);
+  }
+  UnpinFrame(frame_id, false);
 }
 
 bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   std::lock_guard<std::mutex> guard(this->latch_);
-  disk_manager_->DeallocatePage(page_id);
   // 0.   Make sure you call DiskManager::DeallocatePage!
   // 1.   Search the page table for the requested page (P).
   // 1.   If P does not exist, return true.
-  if (page_table_.find(page_id) == page_table_.end()) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    disk_manager_->DeallocatePage(page_id);
     return true;
   }
 
-  frame_id_t frame_id = page_table_[page_id];
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
-  if (pages_[frame_id].pin_count_ != 0) {
+  Page *page = &pages_[frame_id];
+  int unpinned = 0;
+  if (!page->pin_count_.compare_exchange_strong(unpinned, FRAME_CLAIMED)) {
     return false;
   }
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  replacer_->Pin(frame_id);
-  page_table_.erase(page_id);
-  pages_[frame_id].ResetMemory();
-  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
-  pages_[frame_id].pin_count_ = 0;
-  pages_[frame_id].is_dirty_ = false;
+  page->BeginModification();
+  replacer_->Remove(frame_id);
+  page_table_.Remove(page_id);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->EndModification();
   free_list_.push_back(frame_id);
+  // Only now that nobody uses the page can its id be handed out again.
+  disk_manager_->DeallocatePage(page_id);
   return true;
 }
 
 void BufferPoolManager::FlushAllPagesImpl() {
   std::lock_guard<std::mutex> guard(this->latch_);
   // You can do it!
-  for (auto &it : page_table_) {
-    disk_manager_->WritePage(it.first, pages_[it.second].GetData());
-    pages_[it.second].is_dirty_ = false;
+  for (size_t i = 0; i < pool_size_; ++i) {
+    page_id_t page_id = pages_[i].page_id_;
+    if (page_id != INVALID_PAGE_ID) {
+      pages_[i].is_dirty_ = false;
+      disk_manager_->WritePage(page_id, pages_[i].GetData());
+    }
   }
+  disk_manager_->FlushFreeSpaceMap();
 }
 
 }  // namespace bustub
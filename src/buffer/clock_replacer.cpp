@@ -14,16 +14,70 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages)
+    : capacity_(num_pages), states_(std::make_unique<std::atomic<uint8_t>[]>(num_pages)) {
+  for (size_t i = 0; i < capacity_; ++i) {
+    states_[i].store(NOT_IN_CLOCK, std::memory_order_relaxed);
+  }
+}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  // size_ is only updated after the state, so it may briefly count a frame that is already gone. Sweep until either a
+  // victim is found or the clock is really empty.
+  while (size_.load() > 0) {
+    size_t index = clock_hand_.fetch_add(1) % capacity_;
+    uint8_t state = states_[index].load();
+    if (state == REFERENCED) {
+      // Second chance: clear the reference bit, unless another thread changed the frame in the meantime.
+      states_[index].compare_exchange_strong(state, IN_CLOCK);
+    } else if (state == IN_CLOCK && states_[index].compare_exchange_strong(state, NOT_IN_CLOCK)) {
+      size_--;
+      *frame_id = static_cast<frame_id_t>(index);
+      return true;
+    }
+  }
+  return false;
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  if (states_[frame_id].exchange(NOT_IN_CLOCK) != NOT_IN_CLOCK) {
+    size_--;
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  uint8_t state = NOT_IN_CLOCK;
+  if (states_[frame_id].compare_exchange_strong(state, REFERENCED)) {
+    size_++;
+  }
+}
 
-size_t ClockReplacer::Size() { return 0; }
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {
+  if (states_[frame_id].exchange(REFERENCED) == NOT_IN_CLOCK) {
+    size_++;
+  }
+}
+
+void ClockReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  if (capacity_ == 0) {
+    return;
+  }
+  size_t hand = clock_hand_.load() % capacity_;
+  for (uint8_t wanted : {IN_CLOCK, REFERENCED}) {
+    for (size_t i = 0; i < capacity_ && frame_ids->size() < max_frames; ++i) {
+      size_t index = (hand + i) % capacity_;
+      if (states_[index].load(std::memory_order_relaxed) == wanted) {
+        frame_ids->push_back(static_cast<frame_id_t>(index));
+      }
+    }
+  }
+}
+
+size_t ClockReplacer::Size() {
+  int64_t size = size_.load();
+  return size > 0 ? static_cast<size_t>(size) : 0;
+}
 
 }  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k) : k_(k), history_(num_pages), evictable_(num_pages, false) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (evict_set_.empty()) {
+    return false;
+  }
+  *frame_id = evict_set_.begin()->second;
+  evict_set_.erase(evict_set_.begin());
+  evictable_[*frame_id] = false;
+  // The buffer pool may still find the frame pinned again, the history is only forgotten once it calls Remove.
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (evictable_[frame_id]) {
+    evict_set_.erase(KeyOf(frame_id));
+    evictable_[frame_id] = false;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (!evictable_[frame_id]) {
+    Access(frame_id);
+  }
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  Access(frame_id);
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (evictable_[frame_id]) {
+    evict_set_.erase(KeyOf(frame_id));
+    evictable_[frame_id] = false;
+  }
+  history_[frame_id].clear();
+}
+
+void LRUKReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> guard(latch_);
+  for (auto iter = evict_set_.begin(); iter != evict_set_.end() && frame_ids->size() < max_frames; ++iter) {
+    frame_ids->push_back(iter->second);
+  }
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return evict_set_.size();
+}
+
+void LRUKReplacer::Access(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evict_set_.erase(KeyOf(frame_id));
+  }
+  auto &history = history_[frame_id];
+  history.push_back(current_timestamp_++);
+  if (history.size() > k_) {
+    history.pop_front();
+  }
+  evictable_[frame_id] = true;
+  evict_set_.insert(KeyOf(frame_id));
+}
+
+}  // namespace bustub
@@ -58,6 +58,32 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
   }
 }
 
+void LRUReplacer::RecordAccess(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto iter = this->cache_map_.find(frame_id);
+  if (iter != this->cache_map_.end()) {
+    // Already unpinned, move it to the most recently used end.
+    this->cache_list_.splice(this->cache_list_.begin(), this->cache_list_, iter->second);
+    return;
+  }
+  this->cache_list_.push_front(frame_id);
+  this->cache_map_[frame_id] = cache_list_.begin();
+  this->size_++;
+  if (this->size_ > this->capacity_) {
+    frame_id_t back = cache_list_.back();
+    this->cache_list_.pop_back();
+    this->cache_map_.erase(back);
+    this->size_--;
+  }
+}
+
+void LRUReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> guard(latch_);
+  for (auto iter = cache_list_.rbegin(); iter != cache_list_.rend() && frame_ids->size() < max_frames; ++iter) {
+    frame_ids->push_back(*iter);
+  }
+}
+
 size_t LRUReplacer::Size() {
   std::lock_guard<std::mutex> guard(latch_);
   return this->size_;
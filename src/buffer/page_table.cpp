@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) {
+  size_t num_slots = 2;
+  while (num_slots < 2 * num_frames) {
+    num_slots <<= 1;
+  }
+  mask_ = num_slots - 1;
+  slots_ = std::make_unique<std::atomic<slot_t>[]>(num_slots);
+  for (size_t i = 0; i < num_slots; ++i) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+bool PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  // The table is never more than half full, so the probe always reaches an empty slot.
+  for (size_t i = HomeSlot(page_id);; i = (i + 1) & mask_) {
+    slot_t slot = slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageIdOf(slot) == page_id) {
+      *frame_id = FrameIdOf(slot);
+      return true;
+    }
+  }
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  size_t i = HomeSlot(page_id);
+  while (slots_[i].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+    i = (i + 1) & mask_;
+  }
+  slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+}
+
+bool PageTable::Remove(page_id_t page_id) {
+  size_t hole = HomeSlot(page_id);
+  for (;; hole = (hole + 1) & mask_) {
+    slot_t slot = slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageIdOf(slot) == page_id) {
+      break;
+    }
+  }
+
+  // Backward shift deletion: move every following entry whose home slot is not in (hole, i] into the hole, so that
+  // no tombstones are needed and probe sequences stay short.
+  for (size_t i = (hole + 1) & mask_;; i = (i + 1) & mask_) {
+    slot_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = HomeSlot(PageIdOf(slot));
+    bool home_in_range = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+    if (!home_in_range) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = i;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  return true;
+}
+
+}  // namespace bustub
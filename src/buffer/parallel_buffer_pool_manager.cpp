@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type)
+    : BufferPoolManager(0, disk_manager, log_manager, replacer_type) {
+  assert(num_instances > 0);
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; ++i) {
+    instances_.push_back(new BufferPoolManager(pool_size, disk_manager, log_manager, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  for (auto *instance : instances_) {
+    delete instance;
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto *instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+void ParallelBufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids,
+                                              std::shared_ptr<BufferAccessStrategy> strategy) {
+  std::vector<std::vector<page_id_t>> instance_page_ids(instances_.size());
+  for (page_id_t page_id : page_ids) {
+    instance_page_ids[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+  }
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    instances_[i]->PrefetchPages(instance_page_ids[i], strategy);
+  }
+}
+
+Page *ParallelBufferPoolManager::PeekPage(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->PeekPage(page_id);
+}
+
+void ParallelBufferPoolManager::RunBackgroundFlusher(double target_clean_ratio) {
+  for (auto *instance : instances_) {
+    instance->RunBackgroundFlusher(target_clean_ratio);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundFlusher() {
+  for (auto *instance : instances_) {
+    instance->StopBackgroundFlusher();
+  }
+}
+
+void ParallelBufferPoolManager::Debug() {
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    std::cout << "instance " << i << ": ";
+    instances_[i]->Debug();
+  }
+}
+
+BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  assert(page_id != INVALID_PAGE_ID);
+  return instances_[static_cast<size_t>(page_id) % instances_.size()];
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return GetBufferPoolManager(page_id)->FetchPageImpl(page_id, strategy);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  return GetBufferPoolManager(page_id)->UnpinPageImpl(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FlushPageImpl(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id) {
+  // The disk manager hands out page ids, so the instance is decided by the id and not picked round robin. Freed ids
+  // are handed out again, so the ids an instance with all its pages pinned could not take are kept allocated while
+  // the next ones are tried, up to one try per instance.
+  std::vector<page_id_t> rejected_page_ids;
+  Page *page = nullptr;
+  for (size_t i = 0; i < instances_.size() && page == nullptr; ++i) {
+    *page_id = disk_manager_->AllocatePage();
+    page = GetBufferPoolManager(*page_id)->NewPageWithIdImpl(*page_id);
+    if (page == nullptr) {
+      rejected_page_ids.push_back(*page_id);
+      *page_id = INVALID_PAGE_ID;
+    }
+  }
+  for (page_id_t rejected_page_id : rejected_page_ids) {
+    disk_manager_->DeallocatePage(rejected_page_id);
+  }
+  return page;
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->DeletePageImpl(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() {
+  for (auto *instance : instances_) {
+    instance->FlushAllPagesImpl();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,486 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  // 0. a directory of global depth 0, its only slot points to an empty bucket
+  Page *directoryPage = this->buffer_pool_manager_->NewPage(&this->directory_page_id_);
+  if (directoryPage == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+  }
+  page_id_t bucketPageId;
+  Page *bucketPage = this->buffer_pool_manager_->NewPage(&bucketPageId);
+  if (bucketPage == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+  }
+  HashTableDirectoryPage *dirPage = reinterpret_cast<HashTableDirectoryPage *>(directoryPage->GetData());
+  dirPage->Init(this->directory_page_id_);
+  dirPage->SetBucketPageId(0, bucketPageId);
+  ToBucketPage(bucketPage)->Init();
+  this->buffer_pool_manager_->UnpinPage(bucketPageId, true);
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableDirectoryPage *EXTENDIBLE_HASH_TABLE_TYPE::FetchDirectoryPage() {
+  Page *page = this->buffer_pool_manager_->FetchPage(this->directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+  }
+  return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) {
+  Page *page = this->buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * BUCKET CHAINS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchNextChainPage(Page *page, bool exclusive) {
+  page_id_t nextPageId = ToBucketPage(page)->GetNextPageId();
+  if (nextPageId == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *nextPage = this->FetchBucketPage(nextPageId);
+  if (exclusive) {
+    nextPage->WLatch();
+  } else {
+    nextPage->RLatch();
+  }
+  return nextPage;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::ReleaseChainPage(Page *page, bool exclusive, bool is_dirty) {
+  if (exclusive) {
+    page->WUnlatch();
+  } else {
+    page->RUnlatch();
+  }
+  this->buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::ChainInsert(Page *head, const KeyType &key, const ValueType &value, bool *is_full) {
+  // 0. the pair may be on any page of the chain, remember the first one with room on the way
+  page_id_t roomPageId = INVALID_PAGE_ID;
+  for (Page *page = head; page != nullptr;) {
+    BucketPage *bucketPage = ToBucketPage(page);
+    bool found = bucketPage->Contains(key, value, this->comparator_);
+    if (!found && roomPageId == INVALID_PAGE_ID && !bucketPage->IsFull()) {
+      roomPageId = page->GetPageId();
+    }
+    Page *nextPage = found ? nullptr : this->FetchNextChainPage(page, true);
+    if (page != head) {
+      this->ReleaseChainPage(page, true, false);
+    }
+    if (found) {
+      *is_full = false;
+      return false;
+    }
+    page = nextPage;
+  }
+  *is_full = roomPageId == INVALID_PAGE_ID;
+  if (*is_full) {
+    return false;
+  }
+  // 1. the head latch keeps the chain as it was
+  if (roomPageId == head->GetPageId()) {
+    return ToBucketPage(head)->Insert(key, value, this->comparator_);
+  }
+  Page *page = this->FetchBucketPage(roomPageId);
+  page->WLatch();
+  bool inserted = ToBucketPage(page)->Insert(key, value, this->comparator_);
+  this->ReleaseChainPage(page, true, inserted);
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::ChainAppend(Page *head, const KeyType &key, const ValueType &value) {
+  Page *page = head;
+  while (!ToBucketPage(page)->Insert(key, value, this->comparator_)) {
+    Page *nextPage = this->FetchNextChainPage(page, true);
+    bool linked = nextPage == nullptr;
+    if (linked) {
+      // every page is full, a new overflow page ends the chain
+      page_id_t nextPageId;
+      nextPage = this->buffer_pool_manager_->NewPage(&nextPageId);
+      if (nextPage == nullptr) {
+        if (page != head) {
+          this->ReleaseChainPage(page, true, false);
+        }
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+      }
+      nextPage->WLatch();
+      ToBucketPage(nextPage)->Init();
+      ToBucketPage(page)->SetNextPageId(nextPageId);
+    }
+    if (page != head) {
+      this->ReleaseChainPage(page, true, linked);
+    }
+    page = nextPage;
+  }
+  if (page != head) {
+    this->ReleaseChainPage(page, true, true);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::ChainRemove(Page *head, const KeyType &key, const ValueType &value) {
+  // 0. find the page of the pair, keeping the one before it latched to unlink it
+  Page *prevPage = nullptr;
+  Page *page = head;
+  while (page != nullptr && !ToBucketPage(page)->Remove(key, value, this->comparator_)) {
+    Page *nextPage = this->FetchNextChainPage(page, true);
+    if (prevPage != nullptr && prevPage != head) {
+      this->ReleaseChainPage(prevPage, true, false);
+    }
+    prevPage = page;
+    page = nextPage;
+  }
+  bool removed = page != nullptr;
+  page_id_t emptyPageId = INVALID_PAGE_ID;
+  if (removed && ToBucketPage(page)->IsEmpty()) {
+    if (page != head) {
+      // 1. an empty overflow page leaves the chain
+      emptyPageId = page->GetPageId();
+      ToBucketPage(prevPage)->SetNextPageId(ToBucketPage(page)->GetNextPageId());
+    } else {
+      // 2. an empty head takes the pairs of the next page, so that only an empty bucket has an empty head
+      Page *nextPage = this->FetchNextChainPage(head, true);
+      if (nextPage != nullptr) {
+        BucketPage *headPage = ToBucketPage(head);
+        BucketPage *nextBucketPage = ToBucketPage(nextPage);
+        for (uint32_t i = 0; i < nextBucketPage->GetSize(); i++) {
+          headPage->Insert(nextBucketPage->KeyAt(i), nextBucketPage->ValueAt(i), this->comparator_);
+        }
+        headPage->SetNextPageId(nextBucketPage->GetNextPageId());
+        emptyPageId = nextPage->GetPageId();
+        this->ReleaseChainPage(nextPage, true, false);
+      }
+    }
+  }
+  if (page != nullptr && page != head) {
+    this->ReleaseChainPage(page, true, removed);
+  }
+  if (prevPage != nullptr && prevPage != head) {
+    this->ReleaseChainPage(prevPage, true, emptyPageId != INVALID_PAGE_ID);
+  }
+  if (emptyPageId != INVALID_PAGE_ID) {
+    this->buffer_pool_manager_->DeletePage(emptyPageId);
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::ChainDrain(Page *head, std::vector<MappingType> *pairs) {
+  std::vector<page_id_t> overflowPageIds;
+  for (Page *page = head; page != nullptr;) {
+    BucketPage *bucketPage = ToBucketPage(page);
+    for (uint32_t i = 0; i < bucketPage->GetSize(); i++) {
+      pairs->emplace_back(bucketPage->KeyAt(i), bucketPage->ValueAt(i));
+    }
+    Page *nextPage = this->FetchNextChainPage(page, true);
+    if (page != head) {
+      overflowPageIds.push_back(page->GetPageId());
+      this->ReleaseChainPage(page, true, false);
+    }
+    page = nextPage;
+  }
+  ToBucketPage(head)->Init();
+  for (page_id_t pageId : overflowPageIds) {
+    this->buffer_pool_manager_->DeletePage(pageId);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::ChainHashDiff(Page *head, uint32_t hash) {
+  uint32_t diff = 0;
+  for (Page *page = head; page != nullptr;) {
+    BucketPage *bucketPage = ToBucketPage(page);
+    for (uint32_t i = 0; i < bucketPage->GetSize(); i++) {
+      diff |= this->Hash(bucketPage->KeyAt(i)) ^ hash;
+    }
+    Page *nextPage = this->FetchNextChainPage(page, true);
+    if (page != head) {
+      this->ReleaseChainPage(page, true, false);
+    }
+    page = nextPage;
+  }
+  return diff;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  this->table_latch_.RLock();
+  HashTableDirectoryPage *dirPage = this->FetchDirectoryPage();
+  Page *head = this->FetchBucketPage(dirPage->GetBucketPageId(this->KeyToDirectoryIndex(key, dirPage)));
+  head->RLatch();
+  bool found = false;
+  for (Page *page = head; page != nullptr;) {
+    found = ToBucketPage(page)->GetValue(key, this->comparator_, result) || found;
+    Page *nextPage = this->FetchNextChainPage(page, false);
+    if (page != head) {
+      this->ReleaseChainPage(page, false, false);
+    }
+    page = nextPage;
+  }
+  head->RUnlatch();
+  this->buffer_pool_manager_->UnpinPage(head->GetPageId(), false);
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, false);
+  this->table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  // 0. most inserts fit in the bucket of the key, the directory does not change
+  this->table_latch_.RLock();
+  HashTableDirectoryPage *dirPage = this->FetchDirectoryPage();
+  Page *page = this->FetchBucketPage(dirPage->GetBucketPageId(this->KeyToDirectoryIndex(key, dirPage)));
+  page->WLatch();
+  bool isFull = false;
+  bool inserted = this->ChainInsert(page, key, value, &isFull);
+  page->WUnlatch();
+  this->buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, false);
+  this->table_latch_.RUnlock();
+  if (!isFull) {
+    return inserted;
+  }
+  // 1. the bucket is full, split it
+  return this->SplitInsert(transaction, key, value);
+}
+
+/*
+ * A bucket of local depth d holds the keys whose hash share their d low bits.
+ * Splitting it moves the keys whose bit d is set to a new bucket, and the
+ * slots of the bucket with bit d set point to the new bucket. If d already is
+ * the global depth, the directory doubles first. The bucket of the key may
+ * still be full after a split, when all of its keys went the same way, so
+ * splits go on until the pair fits. Splits only go on while some key of the
+ * bucket differs from the new one in a bit from d up to DIRECTORY_MAX_DEPTH,
+ * otherwise no split would ever separate them and the pair goes to an
+ * overflow page of the bucket.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  this->table_latch_.WLock();
+  HashTableDirectoryPage *dirPage = this->FetchDirectoryPage();
+  bool inserted = false;
+  bool dirDirty = false;
+  while (true) {
+    uint32_t bucketIdx = this->KeyToDirectoryIndex(key, dirPage);
+    page_id_t bucketPageId = dirPage->GetBucketPageId(bucketIdx);
+    Page *page = this->FetchBucketPage(bucketPageId);
+    // 0. nobody else is in the table, but page latches keep the page versions right
+    page->WLatch();
+    bool isFull = false;
+    inserted = this->ChainInsert(page, key, value, &isFull);
+    uint32_t localDepth = dirPage->GetLocalDepth(bucketIdx);
+    uint32_t splitBits = (DIRECTORY_ARRAY_SIZE - 1) & ~((1U << localDepth) - 1);
+    if (isFull && (this->ChainHashDiff(page, this->Hash(key)) & splitBits) == 0) {
+      this->ChainAppend(page, key, value);
+      inserted = true;
+      isFull = false;
+    }
+    if (!isFull) {
+      page->WUnlatch();
+      this->buffer_pool_manager_->UnpinPage(bucketPageId, inserted);
+      break;
+    }
+    // 1. grow the directory if the bucket is the only one of its slot
+    if (localDepth == dirPage->GetGlobalDepth()) {
+      dirPage->IncrGlobalDepth();
+    }
+    dirDirty = true;
+    page_id_t imagePageId;
+    Page *imagePage = this->buffer_pool_manager_->NewPage(&imagePageId);
+    if (imagePage == nullptr) {
+      page->WUnlatch();
+      this->buffer_pool_manager_->UnpinPage(bucketPageId, false);
+      this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, dirDirty);
+      this->table_latch_.WUnlock();
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+    }
+    imagePage->WLatch();
+    ToBucketPage(imagePage)->Init();
+    // 2. the slots of the bucket with the split bit set point to the image
+    uint32_t splitBit = 1U << localDepth;
+    for (uint32_t i = 0; i < dirPage->Size(); i++) {
+      if (dirPage->GetBucketPageId(i) == bucketPageId) {
+        dirPage->SetLocalDepth(i, localDepth + 1);
+        if ((i & splitBit) != 0) {
+          dirPage->SetBucketPageId(i, imagePageId);
+        }
+      }
+    }
+    // 3. and so do the pairs whose hash has it, both chains are built again
+    std::vector<MappingType> pairs;
+    this->ChainDrain(page, &pairs);
+    for (const MappingType &pair : pairs) {
+      this->ChainAppend((this->Hash(pair.first) & splitBit) != 0 ? imagePage : page, pair.first, pair.second);
+    }
+    imagePage->WUnlatch();
+    page->WUnlatch();
+    this->buffer_pool_manager_->UnpinPage(imagePageId, true);
+    this->buffer_pool_manager_->UnpinPage(bucketPageId, true);
+  }
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, dirDirty);
+  this->table_latch_.WUnlock();
+  return inserted;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  this->table_latch_.RLock();
+  HashTableDirectoryPage *dirPage = this->FetchDirectoryPage();
+  Page *page = this->FetchBucketPage(dirPage->GetBucketPageId(this->KeyToDirectoryIndex(key, dirPage)));
+  page->WLatch();
+  bool removed = this->ChainRemove(page, key, value);
+  bool isEmpty = ToBucketPage(page)->IsEmpty();
+  page->WUnlatch();
+  this->buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, false);
+  this->table_latch_.RUnlock();
+  // an empty bucket is merged into its split image
+  if (removed && isEmpty) {
+    this->Merge(transaction, key);
+  }
+  return removed;
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+/*
+ * An empty bucket of local depth d is merged with its split image, the bucket
+ * whose slots differ in bit d - 1, if the image has the same local depth. The
+ * slots of both then point to the other one with local depth d - 1. Merges go
+ * on while the merged bucket or its new image is empty, so that buckets left
+ * empty while their image was split deeper are merged too. The bucket may
+ * have been filled again or merged already before the table write latch was
+ * taken, so all of that is checked again.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key) {
+  this->table_latch_.WLock();
+  HashTableDirectoryPage *dirPage = this->FetchDirectoryPage();
+  bool dirDirty = false;
+  while (true) {
+    uint32_t bucketIdx = this->KeyToDirectoryIndex(key, dirPage);
+    uint32_t localDepth = dirPage->GetLocalDepth(bucketIdx);
+    if (localDepth == 0) {
+      break;
+    }
+    uint32_t imageIdx = bucketIdx ^ (1U << (localDepth - 1));
+    if (dirPage->GetLocalDepth(imageIdx) != localDepth) {
+      break;
+    }
+    // 0. keep whichever of the two is not empty
+    page_id_t bucketPageId = dirPage->GetBucketPageId(bucketIdx);
+    page_id_t imagePageId = dirPage->GetBucketPageId(imageIdx);
+    Page *page = this->FetchBucketPage(bucketPageId);
+    bool isEmpty = ToBucketPage(page)->IsEmpty();
+    this->buffer_pool_manager_->UnpinPage(bucketPageId, false);
+    if (!isEmpty) {
+      Page *imagePage = this->FetchBucketPage(imagePageId);
+      bool isImageEmpty = ToBucketPage(imagePage)->IsEmpty();
+      this->buffer_pool_manager_->UnpinPage(imagePageId, false);
+      if (!isImageEmpty) {
+        break;
+      }
+      std::swap(bucketPageId, imagePageId);
+    }
+    // 1. the slots of both point to the one kept
+    for (uint32_t i = 0; i < dirPage->Size(); i++) {
+      page_id_t pageId = dirPage->GetBucketPageId(i);
+      if (pageId == bucketPageId || pageId == imagePageId) {
+        dirPage->SetBucketPageId(i, imagePageId);
+        dirPage->SetLocalDepth(i, localDepth - 1);
+      }
+    }
+    this->buffer_pool_manager_->DeletePage(bucketPageId);
+    dirDirty = true;
+  }
+  // 2. halve the directory while its upper half mirrors the lower
+  while (dirPage->CanShrink()) {
+    dirPage->DecrGlobalDepth();
+    dirDirty = true;
+  }
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, dirDirty);
+  this->table_latch_.WUnlock();
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  this->table_latch_.RLock();
+  HashTableDirectoryPage *dirPage = this->FetchDirectoryPage();
+  uint32_t globalDepth = dirPage->GetGlobalDepth();
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, false);
+  this->table_latch_.RUnlock();
+  return globalDepth;
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  this->table_latch_.RLock();
+  HashTableDirectoryPage *dirPage = this->FetchDirectoryPage();
+  dirPage->VerifyIntegrity();
+  this->buffer_pool_manager_->UnpinPage(this->directory_page_id_, false);
+  this->table_latch_.RUnlock();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
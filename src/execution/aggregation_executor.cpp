@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "execution/executors/aggregation_executor.h"
@@ -28,17 +29,14 @@ const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return c
 
 void AggregationExecutor::Init() {
   this->child_->Init();
-  Tuple tuple;
-  RID rid;
-  while (this->child_->Next(&tuple, &rid)) {
-    AggregateKey agg_key = this->MakeKey(&tuple);
-    AggregateValue agg_val = this->MakeVal(&tuple);
-    // if (this->plan_->GetHaving() != nullptr) {
-    //   if (!this->plan_->GetHaving()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_).GetAs<bool>()) {
-    //     continue;
-    //   }
-    // }
-    this->aht_.InsertCombine(agg_key, agg_val);
+  TupleBatch batch;
+  while (this->child_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      Tuple *tuple = &batch.TupleAt(i);
+      AggregateKey agg_key = this->MakeKey(tuple);
+      AggregateValue agg_val = this->MakeVal(tuple);
+      this->aht_.InsertCombine(agg_key, agg_val);
+    }
   }
   this->aht_iterator_ = this->aht_.Begin();
 }
@@ -48,21 +46,40 @@ bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
     const AggregateKey &agg_key = this->aht_iterator_.Key();
     const AggregateValue &agg_val = this->aht_iterator_.Val();
     ++(this->aht_iterator_);
-    if (this->plan_->GetHaving() != nullptr) {
-      if (!this->plan_->GetHaving()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_).GetAs<bool>()) {
-        continue;
-      }
-    }
-    std::vector<Value> values;
-    for (const Column &col : this->GetOutputSchema()->GetColumns()) {
-      Value value;
-      value = col.GetExpr()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_);
-      values.push_back(value);
+    if (this->produce(agg_key, agg_val, tuple)) {
+      return true;
     }
-    *tuple = Tuple(values, this->GetOutputSchema());
-    return true;
   }
   return false;
 }
 
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  while (!batch->IsFull() && this->aht_iterator_ != this->aht_.End()) {
+    const AggregateKey &agg_key = this->aht_iterator_.Key();
+    const AggregateValue &agg_val = this->aht_iterator_.Val();
+    ++(this->aht_iterator_);
+    if (this->produce(agg_key, agg_val, batch->FreeSlot())) {
+      batch->AppendSlot(RID());
+    }
+  }
+  return !batch->IsEmpty();
+}
+
+bool AggregationExecutor::produce(const AggregateKey &agg_key, const AggregateValue &agg_val, Tuple *tuple) {
+  if (this->plan_->GetHaving() != nullptr) {
+    if (!this->plan_->GetHaving()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_).GetAs<bool>()) {
+      return false;
+    }
+  }
+  std::vector<Value> values;
+  for (const Column &col : this->GetOutputSchema()->GetColumns()) {
+    Value value;
+    value = col.GetExpr()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_);
+    values.push_back(value);
+  }
+  *tuple = Tuple(values, this->GetOutputSchema());
+  return true;
+}
+
 }  // namespace bustub
@@ -0,0 +1,343 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+
+#include "common/exception.h"
+#include "execution/executors/hash_join_executor.h"
+
+namespace bustub {
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {}
+
+HashJoinExecutor::~HashJoinExecutor() { this->dropSpilled(); }
+
+void HashJoinExecutor::Init() {
+  assert(this->left_executor_ != nullptr);
+  assert(this->right_executor_ != nullptr);
+  this->left_executor_->Init();
+  this->right_executor_->Init();
+  this->ht_.clear();
+  this->probe_buffer_.clear();
+  this->probe_buffer_position_ = 0;
+  this->probe_batch_.Clear();
+  this->matches_ = nullptr;
+  this->match_position_ = 0;
+  this->dropSpilled();
+  this->spilled_ = false;
+
+  // 0. read both children in step until one of them ends within the budget, that one is the smaller, or until both
+  // of them outgrow it
+  size_t budget = this->plan_->GetMemoryPages() * PAGE_SIZE;
+  std::vector<Tuple> left_tuples;
+  std::vector<Tuple> right_tuples;
+  size_t left_size = 0;
+  size_t right_size = 0;
+  bool left_done = false;
+  bool right_done = false;
+  TupleBatch batch;
+  while (true) {
+    bool left_fits = left_size <= budget;
+    bool right_fits = right_size <= budget;
+    if ((left_done && left_fits) || (right_done && right_fits) || (!left_fits && !right_fits)) {
+      break;
+    }
+    if (left_fits && !left_done) {
+      left_done = !appendBatch(this->left_executor_.get(), &batch, &left_tuples, &left_size);
+    }
+    if (right_fits && !right_done) {
+      right_done = !appendBatch(this->right_executor_.get(), &batch, &right_tuples, &right_size);
+    }
+  }
+  bool left_builds = left_done && left_size <= budget;
+  bool right_builds = right_done && right_size <= budget;
+  if (!left_builds && !right_builds) {
+    // 1. neither fits, partition both of them on disk
+    this->spill(&left_tuples, left_done, &right_tuples, right_done);
+    return;
+  }
+
+  // 1. build the hash table on the smaller side, the tuples read from the other side are probed first
+  bool build_left = left_builds && (!right_builds || left_size <= right_size);
+  this->probe_done_ = build_left ? right_done : left_done;
+  this->build(build_left ? &left_tuples : &right_tuples, build_left);
+  this->probe_buffer_ = std::move(build_left ? right_tuples : left_tuples);
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const auto &probe_keys = this->build_left_ ? this->plan_->GetRightKeys() : this->plan_->GetLeftKeys();
+  const Schema *probe_schema =
+      this->build_left_ ? this->right_executor_->GetOutputSchema() : this->left_executor_->GetOutputSchema();
+  while (true) {
+    // 1. join the probe tuple with the next build tuple of the same key
+    if (this->matches_ != nullptr && this->match_position_ < this->matches_->size()) {
+      const Tuple *build_tuple = &(*this->matches_)[this->match_position_++];
+      const Tuple *left_tuple = this->build_left_ ? build_tuple : &this->probe_tuple_;
+      const Tuple *right_tuple = this->build_left_ ? &this->probe_tuple_ : build_tuple;
+      if (this->plan_->Predicate() == nullptr ||
+          this->plan_->Predicate()
+              ->EvaluateJoin(left_tuple, this->left_executor_->GetOutputSchema(), right_tuple,
+                             this->right_executor_->GetOutputSchema())
+              .GetAs<bool>()) {
+        *tuple = this->genJoinTuple(left_tuple, right_tuple, this->left_executor_->GetOutputSchema(),
+                                    this->right_executor_->GetOutputSchema());
+        *rid = RID();
+        return true;
+      }
+      continue;
+    }
+    // 2. look the next probe tuple up in the hash table
+    if (!this->nextProbeTuple()) {
+      return false;
+    }
+    this->matches_ = nullptr;
+    this->match_position_ = 0;
+    HashJoinKey key = this->makeKey(&this->probe_tuple_, probe_keys, probe_schema);
+    if (key.HasNull()) {
+      continue;
+    }
+    auto iter = this->ht_.find(key);
+    if (iter != this->ht_.end()) {
+      this->matches_ = &iter->second;
+    }
+  }
+}
+
+bool HashJoinExecutor::appendBatch(AbstractExecutor *executor, TupleBatch *batch, std::vector<Tuple> *tuples,
+                                   size_t *size) {
+  if (!executor->NextBatch(batch)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < batch->Size(); i++) {
+    *size += spillSize(batch->TupleAt(i));
+    tuples->push_back(std::move(batch->TupleAt(i)));
+  }
+  return true;
+}
+
+void HashJoinExecutor::build(std::vector<Tuple> *build_tuples, bool build_left) {
+  // tuples with a null key never join
+  this->build_left_ = build_left;
+  this->ht_.clear();
+  this->matches_ = nullptr;
+  const auto &build_keys = build_left ? this->plan_->GetLeftKeys() : this->plan_->GetRightKeys();
+  const Schema *build_schema =
+      build_left ? this->left_executor_->GetOutputSchema() : this->right_executor_->GetOutputSchema();
+  this->ht_.reserve(build_tuples->size());
+  for (Tuple &build_tuple : *build_tuples) {
+    HashJoinKey key = this->makeKey(&build_tuple, build_keys, build_schema);
+    if (!key.HasNull()) {
+      this->ht_[key].push_back(std::move(build_tuple));
+    }
+  }
+  build_tuples->clear();
+}
+
+void HashJoinExecutor::spill(std::vector<Tuple> *left_tuples, bool left_done, std::vector<Tuple> *right_tuples,
+                             bool right_done) {
+  this->spilled_ = true;
+  std::vector<Partition> left_partitions(HASH_JOIN_PARTITIONS);
+  std::vector<Partition> right_partitions(HASH_JOIN_PARTITIONS);
+  std::vector<Page *> left_pages(HASH_JOIN_PARTITIONS, nullptr);
+  std::vector<Page *> right_pages(HASH_JOIN_PARTITIONS, nullptr);
+  // 0. the tuples read by Init
+  for (const Tuple &tuple : *left_tuples) {
+    this->spillTuple(tuple, true, 1, &left_partitions, &left_pages);
+  }
+  left_tuples->clear();
+  for (const Tuple &tuple : *right_tuples) {
+    this->spillTuple(tuple, false, 1, &right_partitions, &right_pages);
+  }
+  right_tuples->clear();
+  // 1. the rest of both children
+  TupleBatch batch;
+  while (!left_done && this->left_executor_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      this->spillTuple(batch.TupleAt(i), true, 1, &left_partitions, &left_pages);
+    }
+  }
+  while (!right_done && this->right_executor_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      this->spillTuple(batch.TupleAt(i), false, 1, &right_partitions, &right_pages);
+    }
+  }
+  this->finishSpill(&left_pages);
+  this->finishSpill(&right_pages);
+  for (size_t i = 0; i < HASH_JOIN_PARTITIONS; i++) {
+    this->partitions_.push_back({std::move(left_partitions[i]), std::move(right_partitions[i]), 1});
+  }
+}
+
+void HashJoinExecutor::spillTuple(const Tuple &tuple, bool left, uint32_t depth, std::vector<Partition> *partitions,
+                                  std::vector<Page *> *pages) {
+  // tuples with a null key never join
+  const auto &keys = left ? this->plan_->GetLeftKeys() : this->plan_->GetRightKeys();
+  const Schema *schema = left ? this->left_executor_->GetOutputSchema() : this->right_executor_->GetOutputSchema();
+  HashJoinKey key = this->makeKey(&tuple, keys, schema);
+  if (key.HasNull()) {
+    return;
+  }
+  size_t i = partitionOf(key, depth);
+  Page *&page = (*pages)[i];
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (page == nullptr || !reinterpret_cast<TmpTuplePage *>(page)->Insert(tuple, &tmp_tuple)) {
+    // the page of the partition is full, go on with a new one
+    BufferPoolManager *bpm = this->exec_ctx_->GetBufferPoolManager();
+    if (page != nullptr) {
+      bpm->UnpinPage(page->GetPageId(), true);
+    }
+    page_id_t page_id;
+    page = bpm->NewPage(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+    }
+    auto *tmp_page = reinterpret_cast<TmpTuplePage *>(page);
+    tmp_page->Init(page_id, PAGE_SIZE);
+    (*partitions)[i].pages_.push_back(page_id);
+    if (!tmp_page->Insert(tuple, &tmp_tuple)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "tuple is too large to spill to a page");
+    }
+  }
+  (*partitions)[i].size_ += spillSize(tuple);
+}
+
+void HashJoinExecutor::finishSpill(std::vector<Page *> *pages) {
+  for (Page *&page : *pages) {
+    if (page != nullptr) {
+      this->exec_ctx_->GetBufferPoolManager()->UnpinPage(page->GetPageId(), true);
+      page = nullptr;
+    }
+  }
+}
+
+void HashJoinExecutor::readSpilledPage(page_id_t page_id, std::vector<Tuple> *tuples) {
+  BufferPoolManager *bpm = this->exec_ctx_->GetBufferPoolManager();
+  Page *page = bpm->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+  }
+  auto *tmp_page = reinterpret_cast<TmpTuplePage *>(page);
+  for (uint32_t offset = tmp_page->GetFirstOffset(); offset < PAGE_SIZE; offset = tmp_page->GetNextOffset(offset)) {
+    Tuple tuple;
+    tmp_page->Get(TmpTuple(page_id, offset), &tuple);
+    tuples->push_back(std::move(tuple));
+  }
+  bpm->UnpinPage(page_id, false);
+  bpm->DeletePage(page_id);
+}
+
+void HashJoinExecutor::dropPartition(Partition *partition) {
+  for (page_id_t page_id : partition->pages_) {
+    this->exec_ctx_->GetBufferPoolManager()->DeletePage(page_id);
+  }
+  partition->pages_.clear();
+  partition->size_ = 0;
+}
+
+void HashJoinExecutor::dropSpilled() {
+  for (PartitionPair &pair : this->partitions_) {
+    this->dropPartition(&pair.left_);
+    this->dropPartition(&pair.right_);
+  }
+  this->partitions_.clear();
+  for (size_t i = this->probe_page_position_; i < this->probe_pages_.size(); i++) {
+    this->exec_ctx_->GetBufferPoolManager()->DeletePage(this->probe_pages_[i]);
+  }
+  this->probe_pages_.clear();
+  this->probe_page_position_ = 0;
+}
+
+bool HashJoinExecutor::joinNextPartition() {
+  size_t budget = this->plan_->GetMemoryPages() * PAGE_SIZE;
+  while (!this->partitions_.empty()) {
+    PartitionPair pair = std::move(this->partitions_.back());
+    this->partitions_.pop_back();
+    // 0. nothing joins with an empty partition
+    if (pair.left_.pages_.empty() || pair.right_.pages_.empty()) {
+      this->dropPartition(&pair.left_);
+      this->dropPartition(&pair.right_);
+      continue;
+    }
+    bool build_left = pair.left_.size_ <= pair.right_.size_;
+    Partition *build_partition = build_left ? &pair.left_ : &pair.right_;
+    Partition *probe_partition = build_left ? &pair.right_ : &pair.left_;
+    // 1. the smaller side still does not fit, partition both sides again with the hash of the next depth
+    if (build_partition->size_ > budget && pair.depth_ < HASH_JOIN_MAX_DEPTH) {
+      uint32_t depth = pair.depth_ + 1;
+      std::vector<Partition> left_partitions(HASH_JOIN_PARTITIONS);
+      std::vector<Partition> right_partitions(HASH_JOIN_PARTITIONS);
+      std::vector<Page *> pages(HASH_JOIN_PARTITIONS, nullptr);
+      std::vector<Tuple> tuples;
+      for (page_id_t page_id : pair.left_.pages_) {
+        tuples.clear();
+        this->readSpilledPage(page_id, &tuples);
+        for (const Tuple &tuple : tuples) {
+          this->spillTuple(tuple, true, depth, &left_partitions, &pages);
+        }
+      }
+      this->finishSpill(&pages);
+      for (page_id_t page_id : pair.right_.pages_) {
+        tuples.clear();
+        this->readSpilledPage(page_id, &tuples);
+        for (const Tuple &tuple : tuples) {
+          this->spillTuple(tuple, false, depth, &right_partitions, &pages);
+        }
+      }
+      this->finishSpill(&pages);
+      for (size_t i = 0; i < HASH_JOIN_PARTITIONS; i++) {
+        this->partitions_.push_back({std::move(left_partitions[i]), std::move(right_partitions[i]), depth});
+      }
+      continue;
+    }
+    // 2. build the hash table on the smaller side, the other side is probed page by page
+    std::vector<Tuple> build_tuples;
+    for (page_id_t page_id : build_partition->pages_) {
+      this->readSpilledPage(page_id, &build_tuples);
+    }
+    this->build(&build_tuples, build_left);
+    this->probe_pages_ = std::move(probe_partition->pages_);
+    this->probe_page_position_ = 0;
+    return true;
+  }
+  return false;
+}
+
+bool HashJoinExecutor::nextProbeTuple() {
+  while (this->probe_buffer_position_ == this->probe_buffer_.size()) {
+    this->probe_buffer_.clear();
+    this->probe_buffer_position_ = 0;
+    if (!this->spilled_) {
+      // 0. the tuples read by Init come first, then the batches of the probe child
+      AbstractExecutor *probe_executor = this->build_left_ ? this->right_executor_.get() : this->left_executor_.get();
+      size_t size = 0;
+      if (this->probe_done_ || !appendBatch(probe_executor, &this->probe_batch_, &this->probe_buffer_, &size)) {
+        this->probe_done_ = true;
+        return false;
+      }
+    } else if (this->probe_page_position_ < this->probe_pages_.size()) {
+      // 1. the next page of the probe partition
+      this->readSpilledPage(this->probe_pages_[this->probe_page_position_++], &this->probe_buffer_);
+    } else if (!this->joinNextPartition()) {
+      return false;
+    }
+  }
+  this->probe_tuple_ = std::move(this->probe_buffer_[this->probe_buffer_position_++]);
+  return true;
+}
+
+}  // namespace bustub
@@ -11,21 +11,101 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-void IndexScanExecutor::Init() { this->iter_ = this->getBeginIterator(); }
+void IndexScanExecutor::Init() {
+  // a hash index has no order to scan
+  BUSTUB_ASSERT(this->getIndexInfo()->index_type_ == IndexType::BPLUS_TREE_INDEX, "index scan needs a B+ tree index");
+  this->initKeyRange();
+  this->iter_ = this->getBeginIterator(this->has_low_key_ ? &this->low_key_ : nullptr,
+                                       this->has_high_key_ ? &this->high_key_ : nullptr);
+}
+
+void IndexScanExecutor::initKeyRange() {
+  this->has_low_key_ = false;
+  this->has_high_key_ = false;
+  // 1. the keys are only ordered like the column if the index has that single column, with the same type
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(this->plan_->GetPredicate());
+  if (comparison == nullptr || this->getKeyAttrs().size() != 1) {
+    return;
+  }
+  uint32_t keyColumn = this->getKeyAttrs()[0];
+  TypeId keyType = this->getSchema().GetColumn(keyColumn).GetType();
+  if (this->getKeySchema().GetColumn(0).GetType() != keyType) {
+    return;
+  }
+  // 2. column <op> constant, or constant <op> column with the comparison mirrored
+  ComparisonType compType = comparison->GetComparisonType();
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    switch (compType) {
+      case ComparisonType::LessThan:
+        compType = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        compType = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        compType = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        compType = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column == nullptr || constant == nullptr || column->GetColIdx() != keyColumn) {
+    return;
+  }
+  // 3. the constant becomes a key the way the index builds them, which needs it to have the type of the column
+  Value value = constant->Evaluate(nullptr, nullptr);
+  if (value.GetTypeId() != keyType || value.IsNull()) {
+    return;
+  }
+  GenericKey<8> key;
+  this->getTreeIndex()->SetIndexKey(Tuple({value}, &this->getKeySchema()), &key);
+  switch (compType) {
+    case ComparisonType::Equal:
+      this->low_key_ = key;
+      this->has_low_key_ = true;
+      this->high_key_ = key;
+      this->has_high_key_ = true;
+      break;
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      this->low_key_ = key;
+      this->has_low_key_ = true;
+      break;
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual:
+      this->high_key_ = key;
+      this->has_high_key_ = true;
+      break;
+    default:
+      break;
+  }
+}
 
 bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
-  while (this->iter_ != this->getEndIterator()) {
+  while (!this->iter_.isEnd()) {
     // For this project, you can safely assume the key value type for index is
     // <GenericKey<8>, RID, GenericComparator<8>> to not worry about template,
     // though a more general solution is also welcomed
     *rid = (*(this->iter_)).second;
     ++this->iter_;
     this->getTableHeap()->GetTuple(*rid, tuple, this->exec_ctx_->GetTransaction());
-    if (this->plan_->GetPredicate()->Evaluate(tuple, &this->getSchema()).GetAs<bool>()) {
+    if (this->plan_->GetPredicate() == nullptr ||
+        this->plan_->GetPredicate()->Evaluate(tuple, &this->getSchema()).GetAs<bool>()) {
       *tuple = this->genOutputTuple(tuple, &this->getSchema(), this->GetOutputSchema());
       return true;
     }
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "execution/executors/limit_executor.h"
 
 namespace bustub {
@@ -37,4 +39,21 @@ bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
   return false;
 }
 
+bool LimitExecutor::NextBatch(TupleBatch *batch) {
+  size_t end = this->offset_ + this->limit_;
+  while (this->cur_ < end && this->child_executor_->NextBatch(batch)) {
+    // the batch holds the child tuples [first, cur_), keep the ones in [offset_, end)
+    size_t first = this->cur_;
+    this->cur_ += batch->Size();
+    size_t begin = std::max(first, this->offset_);
+    size_t stop = std::min(this->cur_, end);
+    if (begin < stop) {
+      batch->Slice(begin - first, stop - first);
+      return true;
+    }
+  }
+  batch->Clear();
+  return false;
+}
+
 }  // namespace bustub
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <utility>
+
 #include "execution/executors/nested_index_join_executor.h"
 
 namespace bustub {
@@ -19,7 +21,10 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
 void NestIndexJoinExecutor::Init() {
-  this->outer_tuple_ = std::make_unique<Tuple>();
+  this->outer_batch_.Clear();
+  this->inner_rids_.clear();
+  this->batch_position_ = 0;
+  this->inner_position_ = 0;
   assert(this->child_executor_ != nullptr);
   this->child_executor_->Init();
 }
@@ -27,29 +32,57 @@ void NestIndexJoinExecutor::Init() {
 bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
   Tuple right_tuple;
   Tuple inner_tuple;
-  assert(this->outer_tuple_ != nullptr);
-  while (this->child_executor_->Next(this->outer_tuple_.get(), rid)) {
+  while (this->batch_position_ < this->outer_batch_.Size() || this->fetchOuterBatch()) {
+    size_t i = this->batch_position_;
     // i think it is wrong, because i use inner index as outer index. i can't get outer inner :(
-    Tuple key =
-        this->outer_tuple_->KeyFromTuple(*this->plan_->OuterTableSchema(), this->getKeySchema(), this->getKeyAttrs());
-    std::vector<RID> rids;
-    this->getIndex()->ScanKey(key, &rids, this->exec_ctx_->GetTransaction());
-    if (rids.empty()) {
+    if (this->inner_position_ == this->inner_rids_[i].size()) {
+      this->batch_position_++;
+      this->inner_position_ = 0;
       continue;
     }
-    this->getInnerTableHeap()->GetTuple(rids[0], &right_tuple, this->exec_ctx_->GetTransaction());
+    // the key may have several inner tuples, join with each of them
+    const RID &inner_rid = this->inner_rids_[i][this->inner_position_++];
+    Tuple *outer_tuple = &this->outer_batch_.TupleAt(i);
+    this->getInnerTableHeap()->GetTuple(inner_rid, &right_tuple, this->exec_ctx_->GetTransaction());
     inner_tuple = this->genOutputTuple(&right_tuple, &this->getInnerSchema(), this->plan_->InnerTableSchema());
     if (this->plan_->Predicate()
-            ->EvaluateJoin(this->outer_tuple_.get(), this->plan_->OuterTableSchema(), &inner_tuple,
-                           this->plan_->InnerTableSchema())
+            ->EvaluateJoin(outer_tuple, this->plan_->OuterTableSchema(), &inner_tuple, this->plan_->InnerTableSchema())
             .GetAs<bool>()) {
-      *tuple = this->genJoinTuple(this->outer_tuple_.get(), &inner_tuple, this->plan_->OuterTableSchema(),
+      *tuple = this->genJoinTuple(outer_tuple, &inner_tuple, this->plan_->OuterTableSchema(),
                                   this->plan_->InnerTableSchema());
+      *rid = this->outer_batch_.RIDAt(i);
       return true;
     }
   }
-  this->outer_tuple_ = nullptr;
   return false;
 }
 
+bool NestIndexJoinExecutor::fetchOuterBatch() {
+  this->batch_position_ = 0;
+  this->inner_position_ = 0;
+  // 0. pull a batch of outer tuples and build their keys
+  if (!this->child_executor_->NextBatch(&this->outer_batch_)) {
+    return false;
+  }
+  std::vector<Tuple> keys;
+  keys.reserve(this->outer_batch_.Size());
+  for (uint32_t i = 0; i < this->outer_batch_.Size(); i++) {
+    keys.push_back(this->outer_batch_.TupleAt(i).KeyFromTuple(*this->plan_->OuterTableSchema(), this->getKeySchema(),
+                                                              this->getKeyAttrs()));
+  }
+  // 1. probe the inner index with all of them at once, the index shares the descents between close keys
+  this->getIndex()->ScanKeys(keys, &this->inner_rids_, this->exec_ctx_->GetTransaction());
+  return true;
+}
+
+bool NestIndexJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  Tuple tuple;
+  RID rid;
+  while (!batch->IsFull() && this->NestIndexJoinExecutor::Next(&tuple, &rid)) {
+    batch->Append(std::move(tuple), rid);
+  }
+  return !batch->IsEmpty();
+}
+
 }  // namespace bustub
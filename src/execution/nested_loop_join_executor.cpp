@@ -27,6 +27,8 @@ void NestedLoopJoinExecutor::Init() {
   assert(this->right_executor_ != nullptr);
   this->left_executor_->Init();
   this->right_executor_->Init();
+  this->right_batch_.Clear();
+  this->right_position_ = 0;
   outer_tuple_ = std::make_unique<Tuple>();
   RID rid;
   if (!this->left_executor_->Next(this->outer_tuple_.get(), &rid)) {
@@ -61,4 +63,33 @@ bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
   return false;
 }
 
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  while (this->outer_tuple_ != nullptr && !batch->IsFull()) {
+    // 1. if the right batch is used up, pull the next one, or move to the next left tuple and rescan the right table
+    if (this->right_position_ == this->right_batch_.Size()) {
+      this->right_position_ = 0;
+      if (!this->right_executor_->NextBatch(&this->right_batch_)) {
+        RID rid;
+        if (!this->left_executor_->Next(this->outer_tuple_.get(), &rid)) {
+          this->outer_tuple_ = nullptr;
+          break;
+        }
+        this->right_executor_->Init();
+      }
+      continue;
+    }
+    Tuple *right_tuple = &this->right_batch_.TupleAt(this->right_position_++);
+    if (this->plan_->Predicate()
+            ->EvaluateJoin(this->outer_tuple_.get(), left_executor_->GetOutputSchema(), right_tuple,
+                           right_executor_->GetOutputSchema())
+            .GetAs<bool>()) {
+      batch->Append(this->genJoinTuple(this->outer_tuple_.get(), right_tuple, this->left_executor_->GetOutputSchema(),
+                                       this->right_executor_->GetOutputSchema()),
+                    RID());
+    }
+  }
+  return !batch->IsEmpty();
+}
+
 }  // namespace bustub
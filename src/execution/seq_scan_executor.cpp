@@ -9,6 +9,8 @@
 // Copyright (c) 2015-19, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <utility>
+
 #include "execution/executors/seq_scan_executor.h"
 
 namespace bustub {
@@ -19,6 +21,8 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
 void SeqScanExecutor::Init() {
   this->tableHeap_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->table_.get();
   this->iter_ = std::make_unique<TableIterator>(this->tableHeap_->Begin(exec_ctx_->GetTransaction()));
+  this->raw_batch_.Clear();
+  this->raw_position_ = 0;
 }
 
 bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
@@ -27,36 +31,62 @@ bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
   while (iter != this->tableHeap_->End()) {
     raw_tuple = *(iter++);
     *rid = raw_tuple.GetRid();
-    // Test sample oriented programming
-    if (this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ ||
-        this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
-      if (!this->exec_ctx_->GetTransaction()->IsSharedLocked(*rid) &&
-          !this->exec_ctx_->GetTransaction()->IsExclusiveLocked(*rid)) {
-        this->exec_ctx_->GetCatalog()->GetLockManger()->LockShared(this->exec_ctx_->GetTransaction(), *rid);
-      }
+    if (this->produce(&raw_tuple, *rid, tuple)) {
+      return true;
     }
-    bool res = false;
-    if (this->plan_->GetPredicate() == nullptr ||
-        this->plan_->GetPredicate()->Evaluate(&raw_tuple, this->getSchema()).GetAs<bool>()) {
-      *tuple = this->genOutputTuple(&raw_tuple, this->getSchema(), this->GetOutputSchema());
-      if (this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
-        if (!this->exec_ctx_->GetTransaction()->IsSharedLocked(*rid) &&
-            !this->exec_ctx_->GetTransaction()->IsExclusiveLocked(*rid)) {
-          this->exec_ctx_->GetCatalog()->GetLockManger()->LockShared(this->exec_ctx_->GetTransaction(), *rid);
-        }
+  }
+  return false;
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  while (!batch->IsFull()) {
+    // read the table a page at a time
+    if (this->raw_position_ == this->raw_batch_.Size()) {
+      if (*(this->iter_) == this->tableHeap_->End()) {
+        break;
       }
-      res = true;
+      this->raw_batch_.Clear();
+      this->raw_position_ = 0;
+      this->iter_->ReadBatch(&this->raw_batch_);
+      continue;
+    }
+    const Tuple *raw_tuple = &this->raw_batch_.TupleAt(this->raw_position_);
+    RID rid = this->raw_batch_.RIDAt(this->raw_position_++);
+    if (this->produce(raw_tuple, rid, batch->FreeSlot())) {
+      batch->AppendSlot(rid);
     }
-    if (this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
-      if (this->exec_ctx_->GetTransaction()->IsSharedLocked(*rid)) {
-        this->exec_ctx_->GetCatalog()->GetLockManger()->Unlock(this->exec_ctx_->GetTransaction(), *rid);
+  }
+  return !batch->IsEmpty();
+}
+
+bool SeqScanExecutor::produce(const Tuple *raw_tuple, const RID &rid, Tuple *tuple) {
+  // Test sample oriented programming
+  if (this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ ||
+      this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
+    if (!this->exec_ctx_->GetTransaction()->IsSharedLocked(rid) &&
+        !this->exec_ctx_->GetTransaction()->IsExclusiveLocked(rid)) {
+      this->exec_ctx_->GetCatalog()->GetLockManger()->LockShared(this->exec_ctx_->GetTransaction(), rid);
+    }
+  }
+  bool res = false;
+  if (this->plan_->GetPredicate() == nullptr ||
+      this->plan_->GetPredicate()->Evaluate(raw_tuple, this->getSchema()).GetAs<bool>()) {
+    *tuple = this->genOutputTuple(raw_tuple, this->getSchema(), this->GetOutputSchema());
+    if (this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
+      if (!this->exec_ctx_->GetTransaction()->IsSharedLocked(rid) &&
+          !this->exec_ctx_->GetTransaction()->IsExclusiveLocked(rid)) {
+        this->exec_ctx_->GetCatalog()->GetLockManger()->LockShared(this->exec_ctx_->GetTransaction(), rid);
       }
     }
-    if (res) {
-      return true;
+    res = true;
+  }
+  if (this->exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
+    if (this->exec_ctx_->GetTransaction()->IsSharedLocked(rid)) {
+      this->exec_ctx_->GetCatalog()->GetLockManger()->Unlock(this->exec_ctx_->GetTransaction(), rid);
     }
   }
-  return false;
+  return res;
 }
 
 }  // namespace bustub
@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <utility>
+
+#include "common/exception.h"
+#include "execution/executors/sort_executor.h"
+
+namespace bustub {
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+SortExecutor::~SortExecutor() { this->dropRuns(); }
+
+void SortExecutor::Init() {
+  assert(this->child_executor_ != nullptr);
+  this->child_executor_->Init();
+  this->dropRuns();
+  this->entries_.clear();
+  this->position_ = 0;
+  this->num_spilled_runs_ = 0;
+  this->merging_ = false;
+
+  // 0. gather the tuples, sorting and spilling them as a run whenever they outgrow the budget
+  size_t budget = this->plan_->GetMemoryPages() * PAGE_SIZE;
+  size_t size = 0;
+  TupleBatch batch;
+  while (this->child_executor_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      size += spillSize(batch.TupleAt(i));
+      this->entries_.push_back(this->makeEntry(std::move(batch.TupleAt(i))));
+      if (size > budget) {
+        this->spillRun(&this->entries_);
+        size = 0;
+      }
+    }
+  }
+  if (this->runs_.empty()) {
+    std::stable_sort(this->entries_.begin(), this->entries_.end(),
+                     [this](const SortEntry &a, const SortEntry &b) { return this->less(a, b); });
+    return;
+  }
+  if (!this->entries_.empty()) {
+    this->spillRun(&this->entries_);
+  }
+  std::vector<SortEntry>().swap(this->entries_);
+
+  // 1. every run being merged holds a page of tuples, merge groups of them into longer runs until they fit
+  size_t fan_in = std::max<size_t>(this->plan_->GetMemoryPages(), 2);
+  while (this->runs_.size() > fan_in) {
+    this->startMerge(fan_in);
+    std::vector<page_id_t> run;
+    Page *page = nullptr;
+    SortEntry entry;
+    while (this->mergeNext(&entry)) {
+      this->appendToRun(entry.tuple_, &run, &page);
+    }
+    this->exec_ctx_->GetBufferPoolManager()->UnpinPage(page->GetPageId(), true);
+    this->runs_.push_back(std::move(run));
+    this->num_spilled_runs_++;
+  }
+  this->startMerge(this->runs_.size());
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!this->merging_) {
+    if (this->position_ == this->entries_.size()) {
+      return false;
+    }
+    *tuple = std::move(this->entries_[this->position_++].tuple_);
+  } else {
+    SortEntry entry;
+    if (!this->mergeNext(&entry)) {
+      return false;
+    }
+    *tuple = std::move(entry.tuple_);
+  }
+  *rid = tuple->GetRid();
+  return true;
+}
+
+int SortExecutor::CompareValues(const Value &a, const Value &b) {
+  if (a.IsNull() || b.IsNull()) {
+    return static_cast<int>(!a.IsNull()) - static_cast<int>(!b.IsNull());
+  }
+  if (a.CompareLessThan(b) == CmpBool::CmpTrue) {
+    return -1;
+  }
+  if (a.CompareGreaterThan(b) == CmpBool::CmpTrue) {
+    return 1;
+  }
+  return 0;
+}
+
+bool SortExecutor::less(const SortEntry &a, const SortEntry &b) const {
+  const auto &order_bys = this->plan_->GetOrderBys();
+  for (size_t i = 0; i < order_bys.size(); i++) {
+    int cmp = CompareValues(a.keys_[i], b.keys_[i]);
+    if (cmp != 0) {
+      return order_bys[i].first == OrderByType::DESC ? cmp > 0 : cmp < 0;
+    }
+  }
+  return false;
+}
+
+void SortExecutor::spillRun(std::vector<SortEntry> *entries) {
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const SortEntry &a, const SortEntry &b) { return this->less(a, b); });
+  std::vector<page_id_t> run;
+  Page *page = nullptr;
+  for (const SortEntry &entry : *entries) {
+    this->appendToRun(entry.tuple_, &run, &page);
+  }
+  this->exec_ctx_->GetBufferPoolManager()->UnpinPage(page->GetPageId(), true);
+  this->runs_.push_back(std::move(run));
+  this->num_spilled_runs_++;
+  entries->clear();
+}
+
+void SortExecutor::appendToRun(const Tuple &tuple, std::vector<page_id_t> *run, Page **page) {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (*page != nullptr && reinterpret_cast<TmpTuplePage *>(*page)->Insert(tuple, &tmp_tuple)) {
+    return;
+  }
+  // the last page of the run is full, go on with a new one
+  BufferPoolManager *bpm = this->exec_ctx_->GetBufferPoolManager();
+  if (*page != nullptr) {
+    bpm->UnpinPage((*page)->GetPageId(), true);
+  }
+  page_id_t page_id;
+  *page = bpm->NewPage(&page_id);
+  if (*page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+  }
+  auto *tmp_page = reinterpret_cast<TmpTuplePage *>(*page);
+  tmp_page->Init(page_id, PAGE_SIZE);
+  run->push_back(page_id);
+  if (!tmp_page->Insert(tuple, &tmp_tuple)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "tuple is too large to spill to a page");
+  }
+}
+
+void SortExecutor::fillReader(RunReader *reader) {
+  if (reader->position_ < reader->entries_.size() || reader->page_position_ == reader->pages_.size()) {
+    return;
+  }
+  reader->entries_.clear();
+  reader->position_ = 0;
+  BufferPoolManager *bpm = this->exec_ctx_->GetBufferPoolManager();
+  page_id_t page_id = reader->pages_[reader->page_position_++];
+  Page *page = bpm->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+  }
+  auto *tmp_page = reinterpret_cast<TmpTuplePage *>(page);
+  for (uint32_t offset = tmp_page->GetFirstOffset(); offset < PAGE_SIZE; offset = tmp_page->GetNextOffset(offset)) {
+    Tuple tuple;
+    tmp_page->Get(TmpTuple(page_id, offset), &tuple);
+    reader->entries_.push_back(this->makeEntry(std::move(tuple)));
+  }
+  bpm->UnpinPage(page_id, false);
+  bpm->DeletePage(page_id);
+  // the page holds the tuples of the run newest first
+  std::reverse(reader->entries_.begin(), reader->entries_.end());
+}
+
+void SortExecutor::startMerge(size_t num_runs) {
+  this->merging_ = true;
+  this->readers_.clear();
+  this->readers_.resize(num_runs);
+  for (RunReader &reader : this->readers_) {
+    reader.pages_ = std::move(this->runs_.front());
+    this->runs_.pop_front();
+    this->fillReader(&reader);
+  }
+  this->tree_.Build(num_runs, [this](size_t i, size_t j) { return this->readerLess(i, j); });
+}
+
+bool SortExecutor::mergeNext(SortEntry *entry) {
+  if (this->readers_.empty()) {
+    return false;
+  }
+  RunReader &reader = this->readers_[this->tree_.Winner()];
+  if (reader.position_ == reader.entries_.size()) {
+    // the smallest head is an exhausted reader, all of them are
+    return false;
+  }
+  *entry = std::move(reader.entries_[reader.position_++]);
+  this->fillReader(&reader);
+  this->tree_.Replay([this](size_t i, size_t j) { return this->readerLess(i, j); });
+  return true;
+}
+
+void SortExecutor::dropRuns() {
+  BufferPoolManager *bpm = this->exec_ctx_->GetBufferPoolManager();
+  for (const auto &run : this->runs_) {
+    for (page_id_t page_id : run) {
+      bpm->DeletePage(page_id);
+    }
+  }
+  this->runs_.clear();
+  for (const RunReader &reader : this->readers_) {
+    for (size_t i = reader.page_position_; i < reader.pages_.size(); i++) {
+      bpm->DeletePage(reader.pages_[i]);
+    }
+  }
+  this->readers_.clear();
+}
+
+}  // namespace bustub
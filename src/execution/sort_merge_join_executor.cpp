@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_executor.cpp
+//
+// Identification: src/execution/sort_merge_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+
+#include "execution/executors/sort_merge_join_executor.h"
+
+namespace bustub {
+
+SortMergeJoinExecutor::SortMergeJoinExecutor(ExecutorContext *exec_ctx, const SortMergeJoinPlanNode *plan,
+                                             std::unique_ptr<AbstractExecutor> &&left_executor,
+                                             std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  this->left_.key_exprs_ = &plan->GetLeftKeys();
+  this->right_.key_exprs_ = &plan->GetRightKeys();
+  this->left_.executor_ = plan->IsLeftSorted() ? std::move(left_executor)
+                                               : this->sorted(std::move(left_executor), plan->GetLeftPlan(),
+                                                              plan->GetLeftKeys(), &this->left_sort_plan_);
+  this->right_.executor_ = plan->IsRightSorted() ? std::move(right_executor)
+                                                 : this->sorted(std::move(right_executor), plan->GetRightPlan(),
+                                                                plan->GetRightKeys(), &this->right_sort_plan_);
+}
+
+std::unique_ptr<AbstractExecutor> SortMergeJoinExecutor::sorted(
+    std::unique_ptr<AbstractExecutor> &&executor, const AbstractPlanNode *plan,
+    const std::vector<const AbstractExpression *> &key_exprs, std::unique_ptr<SortPlanNode> *sort_plan) {
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys;
+  order_bys.reserve(key_exprs.size());
+  for (const auto *expr : key_exprs) {
+    order_bys.emplace_back(OrderByType::ASC, expr);
+  }
+  *sort_plan = std::make_unique<SortPlanNode>(plan->OutputSchema(), plan, std::move(order_bys));
+  return std::make_unique<SortExecutor>(this->exec_ctx_, sort_plan->get(), std::move(executor));
+}
+
+void SortMergeJoinExecutor::Init() {
+  for (JoinSide *side : {&this->left_, &this->right_}) {
+    side->executor_->Init();
+    side->batch_.Clear();
+    side->batch_position_ = 0;
+    this->advance(side);
+  }
+  this->group_.clear();
+  this->group_keys_.clear();
+  this->group_position_ = 0;
+}
+
+bool SortMergeJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *left_schema = this->left_.executor_->GetOutputSchema();
+  const Schema *right_schema = this->right_.executor_->GetOutputSchema();
+  const AbstractExpression *predicate = this->plan_->Predicate();
+  while (true) {
+    // 0. join the current left tuple with the group of right tuples having its keys
+    while (this->group_position_ < this->group_.size()) {
+      const Tuple &right_tuple = this->group_[this->group_position_++];
+      if (predicate == nullptr ||
+          predicate->EvaluateJoin(&this->left_.tuple_, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+        *tuple = this->genJoinTuple(&this->left_.tuple_, &right_tuple, left_schema, right_schema);
+        *rid = tuple->GetRid();
+        return true;
+      }
+    }
+
+    // 1. move to the next left tuple, it joins the same group again if it has the same keys
+    if (this->group_position_ > 0) {
+      this->advance(&this->left_);
+    }
+    if (!this->left_.has_tuple_) {
+      return false;
+    }
+    this->group_position_ = 0;
+    if (!this->group_.empty() && compareKeys(this->left_.keys_, this->group_keys_) == 0) {
+      // the group of the previous left tuple, restarted
+      continue;
+    }
+    this->group_.clear();
+
+    // 2. skip the right tuples ordering before the left keys, and gather the ones equal to them
+    while (this->right_.has_tuple_ && compareKeys(this->right_.keys_, this->left_.keys_) < 0) {
+      this->advance(&this->right_);
+    }
+    while (this->right_.has_tuple_ && compareKeys(this->right_.keys_, this->left_.keys_) == 0) {
+      this->group_.push_back(std::move(this->right_.tuple_));
+      this->advance(&this->right_);
+    }
+    if (this->group_.empty()) {
+      if (!this->right_.has_tuple_) {
+        // no right tuple is left for the remaining left tuples
+        return false;
+      }
+      this->advance(&this->left_);
+      continue;
+    }
+    this->group_keys_ = this->left_.keys_;
+  }
+}
+
+void SortMergeJoinExecutor::advance(JoinSide *side) {
+  const Schema *schema = side->executor_->GetOutputSchema();
+  while (true) {
+    if (side->batch_position_ == side->batch_.Size()) {
+      side->batch_position_ = 0;
+      if (!side->executor_->NextBatch(&side->batch_)) {
+        side->has_tuple_ = false;
+        return;
+      }
+    }
+    side->tuple_ = std::move(side->batch_.TupleAt(side->batch_position_++));
+    side->keys_.clear();
+    bool has_null = false;
+    for (const auto *expr : *side->key_exprs_) {
+      side->keys_.emplace_back(expr->Evaluate(&side->tuple_, schema));
+      has_null = has_null || side->keys_.back().IsNull();
+    }
+    if (!has_null) {
+      side->has_tuple_ = true;
+      return;
+    }
+  }
+}
+
+}  // namespace bustub
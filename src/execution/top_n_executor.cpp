@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_executor.cpp
+//
+// Identification: src/execution/top_n_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <utility>
+
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/top_n_executor.h"
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void TopNExecutor::Init() {
+  assert(this->child_executor_ != nullptr);
+  this->child_executor_->Init();
+  this->entries_.clear();
+
+  // 0. keep the first n tuples in a max-heap, the last of them on top
+  size_t n = this->plan_->GetOffset() + this->plan_->GetLimit();
+  auto heap_less = [this](const TopNEntry &a, const TopNEntry &b) { return this->less(a, b); };
+  const Schema *child_schema = this->child_executor_->GetOutputSchema();
+  size_t sequence = 0;
+  TupleBatch batch;
+  while (n > 0 && this->child_executor_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      TopNEntry entry{{}, sequence++, Tuple()};
+      entry.keys_.reserve(this->plan_->GetOrderBys().size());
+      for (const auto &order_by : this->plan_->GetOrderBys()) {
+        entry.keys_.emplace_back(order_by.second->Evaluate(&batch.TupleAt(i), child_schema));
+      }
+      if (this->entries_.size() == n) {
+        if (!this->less(entry, this->entries_.front())) {
+          continue;
+        }
+        std::pop_heap(this->entries_.begin(), this->entries_.end(), heap_less);
+        this->entries_.pop_back();
+      }
+      entry.tuple_ = std::move(batch.TupleAt(i));
+      this->entries_.push_back(std::move(entry));
+      std::push_heap(this->entries_.begin(), this->entries_.end(), heap_less);
+    }
+  }
+
+  // 1. order the kept tuples and skip the offset
+  std::sort_heap(this->entries_.begin(), this->entries_.end(), heap_less);
+  this->position_ = std::min(this->plan_->GetOffset(), this->entries_.size());
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+  if (this->position_ == this->entries_.size()) {
+    return false;
+  }
+  *tuple = std::move(this->entries_[this->position_++].tuple_);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+bool TopNExecutor::less(const TopNEntry &a, const TopNEntry &b) const {
+  const auto &order_bys = this->plan_->GetOrderBys();
+  for (size_t i = 0; i < order_bys.size(); i++) {
+    int cmp = SortExecutor::CompareValues(a.keys_[i], b.keys_[i]);
+    if (cmp != 0) {
+      return order_bys[i].first == OrderByType::DESC ? cmp > 0 : cmp < 0;
+    }
+  }
+  return a.sequence_ < b.sequence_;
+}
+
+}  // namespace bustub
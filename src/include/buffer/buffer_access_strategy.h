@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * BufferAccessStrategy gives a sequential scan a small private ring of buffer pool frames. When the scan misses, the
+ * buffer pool recycles the frame of the oldest unpinned page in the ring instead of asking the replacer for a victim,
+ * so a scan over a table much larger than the pool only ever occupies about ring_size frames and leaves the rest of
+ * the pool, e.g. hot index pages, alone.
+ *
+ * A strategy belongs to a single scan. It is shared with the read-ahead of the scan, which brings pages into the ring
+ * from the prefetch threads of the buffer pool, so the ring is protected by a latch.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManager;
+
+ public:
+  /**
+   * Creates a new BufferAccessStrategy.
+   * @param ring_size the number of frames the scan may recycle
+   */
+  explicit BufferAccessStrategy(size_t ring_size = SCAN_RING_SIZE) : ring_size_(ring_size) {}
+
+  /** @return the number of frames the scan may recycle */
+  size_t GetRingSize() const { return ring_size_; }
+
+ private:
+  /** Remember a page the scan brought into the pool, forgetting the oldest one if the ring is full. */
+  void AddPage(page_id_t page_id) {
+    std::lock_guard<std::mutex> guard(latch_);
+    ring_.push_back(page_id);
+    if (ring_.size() > ring_size_) {
+      ring_.pop_front();
+    }
+  }
+
+  size_t ring_size_;
+  /** Pages the scan brought into the pool, oldest first. They may have been evicted by others since. */
+  std::deque<page_id_t> ring_;
+  /** Protects ring_. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,11 +12,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
+#include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/page_table.h"
 #include "common/logger.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -28,6 +37,9 @@ namespace bustub {
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
 class BufferPoolManager {
+  // ParallelBufferPoolManager routes every call to the *Impl methods of the instance that owns the page.
+  friend class ParallelBufferPoolManager;
+
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
@@ -37,13 +49,15 @@ class BufferPoolManager {
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victim frames
    */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                    ReplacerType replacer_type = ReplacerType::LRU);
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
@@ -54,6 +68,17 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Fetch a page on behalf of a sequential scan. On a miss the page is read into a frame from the scan's ring when
+   * possible, instead of a victim picked by the replacer.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the scan
+   * @return the requested page, nullptr if no frame is available
+   */
+  Page *FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) {
+    return FetchPageImpl(page_id, strategy);
+  }
+
   /** Grading function. Do not modify! */
   bool UnpinPage(page_id_t page_id, bool is_dirty, bufferpool_callback_fn callback = nullptr) {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -96,13 +121,58 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Look up the frame of a resident page without pinning it, for optimistic readers that write no shared memory. The
+   * frame may be replaced at any time: the caller reads it between Page::GetVersion and Page::ValidateVersion, and
+   * checks that it still holds the page before validating. A frame's version is odd while it is being replaced.
+   * @param page_id id of the page
+   * @return the frame holding the page, nullptr if the page is not resident
+   */
+  virtual Page *PeekPage(page_id_t page_id);
+
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
   /** @return size of the buffer pool */
-  size_t GetPoolSize() { return pool_size_; }
+  virtual size_t GetPoolSize() { return pool_size_; }
+
+  /**
+   * Asks the buffer pool to bring pages in ahead of their use. The call returns immediately, a prefetch thread reads
+   * the pages that are not resident yet, batching runs of consecutive page ids into a single disk read. Prefetched
+   * pages are left unpinned. Page ids that were never allocated are ignored.
+   * @param page_ids ids of the pages to prefetch
+   * @param strategy the access strategy of the scan the pages are read for, nullptr for a normal access
+   */
+  virtual void PrefetchPages(const std::vector<page_id_t> &page_ids,
+                             std::shared_ptr<BufferAccessStrategy> strategy = nullptr);
+
+  /**
+   * Read-ahead for iterators that follow a chain of pages. When the chain is sequential, i.e. the next page id is the
+   * current one plus one, pages up to READ_AHEAD_PAGES past the next page are prefetched, otherwise only the next page.
+   * The window is extended once the iterator gets within half a window of its end.
+   * @param page_id id of the page the iterator is on
+   * @param next_page_id id of the next page in the chain, INVALID_PAGE_ID at the end of the chain
+   * @param window_end end (exclusive) of the window prefetched so far, INVALID_PAGE_ID for none
+   * @param strategy the access strategy of the scan, nullptr for a normal access
+   * @return the new end of the window
+   */
+  page_id_t ReadAhead(page_id_t page_id, page_id_t next_page_id, page_id_t window_end,
+                      const std::shared_ptr<BufferAccessStrategy> &strategy = nullptr);
+
+  /**
+   * Starts a background thread that writes back dirty pages about to be victimized, so that misses find clean victims
+   * and only have to read. Every background_flush_interval, and whenever a miss had to write back its victim, the
+   * thread cleans the dirty pages among the next target_clean_ratio * pool size victims of the replacer.
+   * @param target_clean_ratio the fraction of the buffer pool, taken from the replacer tail, to keep clean
+   */
+  virtual void RunBackgroundFlusher(double target_clean_ratio);
 
-  void Debug() {
+  /**
+   * Stops and joins the background flusher thread, if it is running.
+   */
+  virtual void StopBackgroundFlusher();
+
+  virtual void Debug() {
     std::cout << "free_list_.size() = " << free_list_.size() << " , replacer_.size() = " << replacer_->Size()
               << std::endl;
   }
@@ -126,7 +196,15 @@ class BufferPoolManager {
    * @param page_id id of page to be fetched
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  Page *FetchPageImpl(page_id_t page_id) { return FetchPageImpl(page_id, nullptr); }
+
+  /**
+   * Fetch the requested page from the buffer pool.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of a sequential scan, nullptr for a normal access
+   * @return the requested page
+   */
+  virtual Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy);
 
   /**
    * Unpin the target page from the buffer pool.
@@ -134,49 +212,176 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id);
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageImpl(page_id_t *page_id);
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
+  virtual bool DeletePageImpl(page_id_t page_id);
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPagesImpl();
+  virtual void FlushAllPagesImpl();
+
+  /**
+   * Creates a page with an already allocated page id in the buffer pool.
+   * @param page_id id of the page, obtained from DiskManager::AllocatePage
+   * @return nullptr if all the frames are pinned, otherwise pointer to the new page
+   */
+  Page *NewPageWithIdImpl(page_id_t page_id);
+
+  /**
+   * Find a frame for a new page, from the free list first and then from the replacer.
+   * A dirty victim is written back and removed from the page table. Caller must hold latch_.
+   * @param[out] frame_id id of the frame found
+   * @return false if all the frames are pinned, true otherwise
+   */
+  bool FindVictimFrame(frame_id_t *frame_id);
+
+  /**
+   * Find an unpinned page of the scan's ring that lives in this buffer pool, and take over its frame. The page is
+   * written back if dirty and removed from the page table and from the ring. Nothing is recycled before the ring holds
+   * ring_size pages. Caller must hold latch_.
+   * @param strategy the access strategy of the scan
+   * @param[out] frame_id id of the frame found
+   * @return false if no page of the ring can be replaced, true otherwise
+   */
+  bool ReuseRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id);
+
+  /**
+   * Write back the page of a claimed frame if it is dirty, and remove it from the page table. The page version stays
+   * odd until the frame holds a page again, so that optimistic readers of the old page fail to validate. Caller must
+   * hold latch_.
+   * @param frame_id id of the frame, its pin count must be FRAME_CLAIMED
+   */
+  void EvictFrame(frame_id_t frame_id);
+
+  /**
+   * Drop a resident copy of a page whose id is being handed out for a new page. The copy is either stale, the page was
+   * deallocated and its id reused, or was loaded by a read-ahead before the page was initialized. Nobody uses it yet,
+   * so its frame goes back to the free list. A copy that LoadPages is still reading is waited for first.
+   * @param page_id id of the new page
+   * @param lock the caller's hold of latch_, released while waiting
+   */
+  void DropStaleCopy(page_id_t page_id, std::unique_lock<std::mutex> *lock);
+
+  /**
+   * Reset the frame to hold a fresh, pinned page. Caller must hold latch_.
+   * @param frame_id id of the frame to reset
+   * @param page_id id of the page which will live in the frame
+   * @return pointer to the new page
+   */
+  Page *InitNewPage(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Pin the frame if it still holds the given page, without taking latch_.
+   * @param frame_id id of the frame the page table pointed to
+   * @param page_id id of the page the caller is looking for
+   * @return true if the page is pinned, false if the frame is being replaced or holds another page
+   */
+  bool TryPinFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Decrement the pin count of a frame, and hand the frame to the replacer once nobody pins it.
+   * @param frame_id id of the frame to unpin
+   * @param record_access false if the pin was not an access to the page, so that its recency is left untouched
+   * @return false if the pin count was <= 0 before this call, true otherwise
+   */
+  bool UnpinFrame(frame_id_t frame_id, bool record_access = true);
+
+  /**
+   * Read the given pages into free or victim frames, one disk read per run of consecutive page ids. Pages that are
+   * already resident or were never allocated are skipped. Takes latch_ to claim the frames and to publish the pages,
+   * but not while reading them.
+   * @param page_ids ids of the pages to load
+   * @param strategy the access strategy of the scan the pages are read for, nullptr for a normal access
+   */
+  void LoadPages(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy);
+
+  /**
+   * One round of the background flusher: write back the dirty pages among the next victims of the replacer.
+   * Does not take latch_, the pages are pinned while they are written.
+   */
+  void CleanVictimFrames();
+
+  /**
+   * Write back the page in the frame if it is dirty, without taking latch_ and without counting as an access.
+   * @param frame_id id of the frame to clean
+   */
+  void CleanFrame(frame_id_t frame_id);
+
+  /**
+   * Pin count of a frame that is in the free list, being replaced or being read by LoadPages. It can only be set from 0
+   * under latch_, so TryPinFrame, which only ever increments a non-negative pin count, can never pin such a frame.
+   */
+  static constexpr int FRAME_CLAIMED = -1;
 
   /** Number of pages in the buffer pool. */
   size_t pool_size_;
   /** Array of buffer pool pages. */
   Page *pages_;
+  /** Mapping that holds pages_, aligned to the OS page size and optionally backed by huge pages. */
+  void *frame_arena_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Page table for keeping track of buffer pool pages. Readable without latch_, written only under latch_. */
+  PageTable page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * This latch serializes misses, evictions and deletions: it protects free_list_, writes to page_table_, and the
+   * transition of a frame from an unpinned page to FRAME_CLAIMED. Hits and unpins only use atomics on the Page.
+   */
   std::mutex latch_;
+  /** Wakes up the misses waiting, with latch_, for LoadPages to finish reading their page. */
+  std::condition_variable load_cv_;
+
+  /** Background flusher thread, nullptr if it is not running. */
+  std::thread *flusher_thread_{nullptr};
+  /** Tells the background flusher to keep running. */
+  std::atomic<bool> flusher_running_{false};
+  /** Fraction of the buffer pool the background flusher keeps clean. */
+  double target_clean_ratio_{0};
+  /** Wakes up the background flusher early, when a miss had to write back its victim or on shutdown. */
+  std::condition_variable flusher_cv_;
+  /** Protects flusher_cv_. */
+  std::mutex flusher_latch_;
+
+  /** A batch of pages to prefetch. */
+  struct PrefetchRequest {
+    std::vector<page_id_t> page_ids_;
+    std::shared_ptr<BufferAccessStrategy> strategy_;
+  };
+  /** Prefetch thread, started by the first PrefetchPages call. */
+  std::thread *prefetch_thread_{nullptr};
+  /** Tells the prefetch thread to keep running. */
+  bool prefetch_running_{false};
+  /** Prefetch requests not picked up by the prefetch thread yet. */
+  std::deque<PrefetchRequest> prefetch_queue_;
+  /** Wakes up the prefetch thread when a request is queued or on shutdown. */
+  std::condition_variable prefetch_cv_;
+  /** Protects prefetch_thread_, prefetch_running_ and prefetch_queue_. */
+  std::mutex prefetch_latch_;
 };
 }  // namespace bustub
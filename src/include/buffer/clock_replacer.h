@@ -12,8 +12,8 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -23,6 +23,9 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every frame has one atomic state byte in a flat array, and the clock hand is an atomic counter, so Pin, Unpin and
+ * Victim never allocate and never block each other.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -41,12 +44,30 @@ class ClockReplacer : public Replacer {
 
   void Pin(frame_id_t frame_id) override;
 
+  /** Adds the frame to the clock with its reference bit set. A frame already in the clock is left as is. */
   void Unpin(frame_id_t frame_id) override;
 
+  /** Sets the reference bit, adding the frame to the clock if needed. */
+  void RecordAccess(frame_id_t frame_id) override;
+
+  /** Lists the frames the hand would take on its next sweep, then the ones it would take on the sweep after. */
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
+  /** The frame is pinned, i.e. not in the clock. */
+  static constexpr uint8_t NOT_IN_CLOCK = 0;
+  /** The frame is in the clock and its reference bit is cleared, the next time the hand passes it is the victim. */
+  static constexpr uint8_t IN_CLOCK = 1;
+  /** The frame is in the clock and its reference bit is set. */
+  static constexpr uint8_t REFERENCED = 2;
+
+  size_t capacity_;
+  std::unique_ptr<std::atomic<uint8_t>[]> states_;
+  std::atomic<size_t> clock_hand_{0};
+  /** Signed, as a Pin racing with the Unpin of the same frame may decrement before the increment lands. */
+  std::atomic<int64_t> size_{0};
 };
 
 }  // namespace bustub
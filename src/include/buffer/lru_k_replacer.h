@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the evictable frame whose K-th most recent access is the oldest. Frames with fewer than K recorded
+ * accesses have an infinite backward K-distance and are evicted first, oldest access first. A page touched once by a
+ * sequential scan therefore leaves before a page that point lookups keep coming back to.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of accesses remembered per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = 2);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  /** Evicts a frame, its access history is kept until the eviction is confirmed with Remove. */
+  bool Victim(frame_id_t *frame_id) override;
+
+  /** Makes the frame non evictable, its access history is kept. */
+  void Pin(frame_id_t frame_id) override;
+
+  /** Makes the frame evictable, recording an access if it was pinned. */
+  void Unpin(frame_id_t frame_id) override;
+
+  /** Records an access and makes the frame evictable. */
+  void RecordAccess(frame_id_t frame_id) override;
+
+  /** Makes the frame non evictable and forgets its access history. */
+  void Remove(frame_id_t frame_id) override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  size_t Size() override;
+
+ private:
+  /** Ordering of evictable frames: frames with fewer than k accesses first, then by their oldest remembered access. */
+  using EvictKey = std::pair<std::pair<bool, uint64_t>, frame_id_t>;
+
+  EvictKey KeyOf(frame_id_t frame_id) const {
+    return {{history_[frame_id].size() >= k_, history_[frame_id].front()}, frame_id};
+  }
+
+  void Access(frame_id_t frame_id);
+
+  size_t k_;
+  /** Logical clock, incremented on every access. */
+  uint64_t current_timestamp_{0};
+  /** The last k access timestamps of every frame, oldest first. */
+  std::vector<std::deque<uint64_t>> history_;
+  std::vector<bool> evictable_;
+  std::set<EvictKey> evict_set_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps page ids to frame ids for the buffer pool. It is an open-addressing hash table with linear probing,
+ * where each slot is a single atomic word holding both ids.
+ *
+ * Find never takes a lock, so the buffer pool can serve hits without touching its latch. Insert and Remove must be
+ * serialized by the caller (the buffer pool latch). Remove uses backward shift deletion, so a concurrent Find may
+ * miss an entry that is being moved; the result of Find is a hint that callers must validate, and a miss must be
+ * retried while holding the latch.
+ */
+class PageTable {
+ public:
+  /**
+   * Create a new PageTable.
+   * @param num_frames the maximum number of entries, i.e. the number of frames of the buffer pool
+   */
+  explicit PageTable(size_t num_frames);
+
+  ~PageTable() = default;
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  /**
+   * Lock-free lookup.
+   * @param page_id id of the page to look up
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Insert a mapping for a page that is not in the table yet. Caller must serialize writers.
+   * @param page_id id of the page
+   * @param frame_id the frame holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Remove the mapping of a page. Caller must serialize writers.
+   * @param page_id id of the page
+   * @return true if the page was in the table
+   */
+  bool Remove(page_id_t page_id);
+
+ private:
+  using slot_t = uint64_t;
+  static constexpr slot_t EMPTY_SLOT = ~static_cast<slot_t>(0);
+
+  static slot_t Pack(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<slot_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t PageIdOf(slot_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static frame_id_t FrameIdOf(slot_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the home slot of the page, page ids are mostly sequential so they are scrambled first */
+  size_t HomeSlot(page_id_t page_id) const {
+    return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >>
+                               32) &
+           mask_;
+  }
+
+  /** Number of slots minus one, the number of slots is a power of two at least twice the number of frames. */
+  size_t mask_;
+  std::unique_ptr<std::atomic<slot_t>[]> slots_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager splits the buffer pool into several independent BufferPoolManager instances. A page is
+ * always cached by the instance page_id % num_instances, and every instance has its own latch, page table, free list
+ * and replacer, so accesses to pages owned by different instances never contend.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManager instances
+   * @param pool_size the pool size of each instance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return the total number of frames of all the instances */
+  size_t GetPoolSize() override;
+
+  /**
+   * Hands every instance the pages it owns. Consecutive page ids live in different instances, so each instance reads
+   * its pages with separate I/Os.
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids,
+                     std::shared_ptr<BufferAccessStrategy> strategy = nullptr) override;
+
+  Page *PeekPage(page_id_t page_id) override;
+
+  /** Every instance runs its own background flusher. */
+  void RunBackgroundFlusher(double target_clean_ratio) override;
+
+  void StopBackgroundFlusher() override;
+
+  void Debug() override;
+
+  /** @return the number of instances */
+  size_t GetNumInstances() const { return instances_.size(); }
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the instance responsible for handling the given page id
+   */
+  BufferPoolManager *GetBufferPoolManager(page_id_t page_id);
+
+  Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  /**
+   * Allocates the page id from the disk manager, then creates the page in the instance owning that id.
+   * @param[out] page_id id of created page
+   * @return nullptr if the owning instance has no frame left, otherwise pointer to new page
+   */
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+ private:
+  /** The individual buffer pool instances, instances_[i] caches the pages with page_id % size == i. */
+  std::vector<BufferPoolManager *> instances_;
+};
+
+}  // namespace bustub
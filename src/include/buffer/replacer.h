@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a BufferPoolManager can be created with. */
+enum class ReplacerType { LRU, CLOCK, LRU_K };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,6 +48,32 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Records an access to a frame that is now unpinned. Unlike Unpin, this also refreshes a frame that is already in
+   * the replacer: the buffer pool does not pin frames in the replacer on a hit, so repeated Unpin calls are the only
+   * sign that a frame is still in use.
+   * @param frame_id the id of the frame that was accessed
+   */
+  virtual void RecordAccess(frame_id_t frame_id) {
+    Pin(frame_id);
+    Unpin(frame_id);
+  }
+
+  /**
+   * Forgets a frame whose page leaves the buffer pool, e.g. a deleted page or a victim that was actually evicted. A
+   * victim the buffer pool finds pinned again is not removed, and goes back in when it is unpinned.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Lists the frames that would be victimized next, without removing them, so that their pages can be written back
+   * ahead of time. The default lists nothing.
+   * @param max_frames the maximum number of frames to list
+   * @param[out] frame_ids the frames, next victim first
+   */
+  virtual void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
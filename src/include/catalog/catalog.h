@@ -9,6 +9,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "storage/index/b_plus_tree_index.h"
+#include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
 #include "storage/table/table_heap.h"
 
@@ -21,6 +22,9 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The kind of an index: a B+ tree answers equality and range lookups, a hash index only equality lookups. */
+enum class IndexType { BPLUS_TREE_INDEX, HASH_INDEX };
+
 /**
  * Metadata about a table.
  */
@@ -38,19 +42,21 @@ struct TableMetadata {
  */
 struct IndexInfo {
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPLUS_TREE_INDEX)
       : key_schema_(std::move(key_schema)),
         name_(std::move(name)),
         index_(std::move(index)),
         index_oid_(index_oid),
         table_name_(std::move(table_name)),
-        key_size_(key_size) {}
+        key_size_(key_size),
+        index_type_(index_type) {}
   Schema key_schema_;
   std::string name_;
   std::unique_ptr<Index> index_;
   index_oid_t index_oid_;
   std::string table_name_;
   const size_t key_size_;
+  IndexType index_type_;
 };
 
 /**
@@ -110,31 +116,47 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param index_type the kind of index to create
    * @return a pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
+                         size_t keysize, IndexType index_type = IndexType::BPLUS_TREE_INDEX) {
     BUSTUB_ASSERT(this->index_names_.count(index_name) == 0, "Index names should be unique!");
     BUSTUB_ASSERT(this->names_.count(table_name) != 0, "table_name names should be exist!");
     BUSTUB_ASSERT(this->tables_.count(this->names_[table_name]) != 0, "table_name names should be exist!");
     index_oid_t index_oid = this->next_index_oid_.fetch_add(1);
     // below varient will be move
-    std::unique_ptr<Index> index(new BPlusTreeIndex<KeyType, ValueType, KeyComparator>(
-        new IndexMetadata(std::string(index_name), std::string(table_name), &schema, std::vector<uint32_t>(key_attrs)),
-        this->bpm_));
-    IndexInfo *indexInfo = new IndexInfo(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
-    this->indexes_.insert({index_oid, std::unique_ptr<IndexInfo>(indexInfo)});
-    this->index_names_[table_name][index_name] = index_oid;
-    // populate existing data of the table
+    auto *metadata =
+        new IndexMetadata(std::string(index_name), std::string(table_name), &schema, std::vector<uint32_t>(key_attrs));
     auto iter = this->GetTable(table_name)->table_->Begin(txn);
     auto iter_end = this->GetTable(table_name)->table_->End();
-    while (iter != iter_end) {
-      Tuple key = iter->KeyFromTuple(schema, key_schema, key_attrs);
-      indexInfo->index_->InsertEntry(key, iter->GetRid(), txn);
-      iter++;
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::HASH_INDEX) {
+      // populate existing data of the table one entry at a time
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(metadata, this->bpm_);
+      for (; iter != iter_end; iter++) {
+        index->InsertEntry(iter->KeyFromTuple(schema, key_schema, key_attrs), iter->GetRid(), txn);
+      }
+    } else {
+      // populate existing data of the table, the index is built bottom-up from the sorted entries
+      auto *treeIndex = new BPlusTreeIndex<KeyType, ValueType, KeyComparator>(metadata, this->bpm_);
+      index.reset(treeIndex);
+      treeIndex->BulkLoad([&](Tuple *key, ValueType *rid) {
+        if (iter == iter_end) {
+          return false;
+        }
+        *key = iter->KeyFromTuple(schema, key_schema, key_attrs);
+        *rid = iter->GetRid();
+        iter++;
+        return true;
+      });
     }
+    IndexInfo *indexInfo =
+        new IndexInfo(key_schema, index_name, std::move(index), index_oid, table_name, keysize, index_type);
+    this->indexes_.insert({index_oid, std::unique_ptr<IndexInfo>(indexInfo)});
+    this->index_names_[table_name][index_name] = index_oid;
 
     return indexInfo;
   }
@@ -24,9 +24,15 @@ extern std::chrono::milliseconds cycle_detection_interval;
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
+/** True if new buffer pools should back their frames with huge pages, false otherwise. */
+extern std::atomic<bool> enable_huge_pages;
+
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** The background flusher of the buffer pool cleans dirty frames every BACKGROUND_FLUSH_INTERVAL milliseconds. */
+extern std::chrono::milliseconds background_flush_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
@@ -35,6 +41,18 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int SCAN_RING_SIZE = 16;                                     // frames recycled by a sequential scan
+static constexpr int READ_AHEAD_PAGES = 8;                                    // pages read ahead of a scan
+static constexpr int IO_URING_QUEUE_DEPTH = 64;                               // io_uring submission queue depth
+static constexpr int DIRECT_IO_ALIGNMENT = 512;                               // O_DIRECT alignment of most devices
+static constexpr int OPTIMISTIC_READ_ATTEMPTS = 8;                            // B+ tree descents before latching
+static constexpr int EXTERNAL_SORT_BUFFER_PAGES = 4096;                       // pages of records sorted in memory
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;                          // B+ tree pages filled by a bulk load
+static constexpr int INDEX_JOIN_BATCH_SIZE = 256;                             // outer tuples probed at once
+static constexpr int EXECUTION_BATCH_SIZE = 1024;                             // tuples passed up per NextBatch
+static constexpr int HASH_JOIN_MEMORY_PAGES = 256;                            // pages of tuples a hash join builds on
+static constexpr int HASH_JOIN_PARTITIONS = 8;                                // partitions a hash join spills into
+static constexpr int HASH_JOIN_MAX_DEPTH = 4;                                 // times a partition is split again
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/common/util/loser_tree.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree picks the smallest of the heads of k sorted sources in a k-way merge.
+ *
+ * Every inner node of the tournament keeps the source that lost the match played there, and the root keeps the
+ * overall winner. Once the winner's source moves to its next item, only the matches on the path from its leaf to the
+ * root are replayed, log2(k) comparisons against the losers kept there. A binary heap needs about twice as many.
+ *
+ * The sources are identified by their index, and compared with less(i, j), which tells if the head of source i
+ * orders before the head of source j. An exhausted source must order after every other source.
+ */
+class LoserTree {
+ public:
+  /** Plays the whole tournament between k sources. */
+  template <typename Less>
+  void Build(size_t k, Less less) {
+    k_ = k;
+    tree_.assign(k, 0);
+    if (k == 0) {
+      return;
+    }
+    // the leaf of source i is node k + i, the winner of node n plays at node n / 2
+    std::vector<size_t> winners(2 * k);
+    for (size_t i = 0; i < k; i++) {
+      winners[k + i] = i;
+    }
+    for (size_t n = k - 1; n >= 1; n--) {
+      size_t a = winners[2 * n];
+      size_t b = winners[2 * n + 1];
+      bool b_wins = less(b, a);
+      winners[n] = b_wins ? b : a;
+      tree_[n] = b_wins ? a : b;
+    }
+    tree_[0] = k == 1 ? 0 : winners[1];
+  }
+
+  /** @return the source whose head is the smallest */
+  size_t Winner() const { return tree_[0]; }
+
+  /** Replays the matches of the winner after its source moved to its next item. */
+  template <typename Less>
+  void Replay(Less less) {
+    size_t winner = tree_[0];
+    for (size_t n = (k_ + winner) / 2; n >= 1; n /= 2) {
+      if (less(tree_[n], winner)) {
+        std::swap(tree_[n], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  size_t k_{0};
+  // tree_[0] is the winner, tree_[n] the loser of the match at inner node n
+  std::vector<size_t> tree_;
+};
+
+}  // namespace bustub
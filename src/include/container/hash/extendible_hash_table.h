@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete. The
+ * table grows one bucket split at a time when a bucket fills up, and shrinks
+ * one bucket merge at a time when a bucket empties. A full bucket that no
+ * split can help, because its keys share all the hash bits the directory can
+ * use, grows a chain of overflow pages instead, so an insert of a new pair
+ * never fails.
+ *
+ * Lookups, inserts and removes that do not split or merge only read latch the
+ * table, and latch the head page of the one bucket they touch. Splits and merges write
+ * latch the table, which is all it takes to change the directory.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable with a single empty bucket.
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair is already there
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /** @return the global depth of the directory */
+  uint32_t GetGlobalDepth();
+
+  /** Asserts that the directory is consistent, see HashTableDirectoryPage::VerifyIntegrity. */
+  void VerifyIntegrity();
+
+ private:
+  using BucketPage = HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+  /** @return the lower 32 bits of the hash of a key */
+  uint32_t Hash(KeyType key) { return static_cast<uint32_t>(this->hash_fn_.GetHash(key)); }
+
+  /** @return the directory slot of a key */
+  uint32_t KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) {
+    return this->Hash(key) & dir_page->GetGlobalDepthMask();
+  }
+
+  /** @return the pinned directory page */
+  HashTableDirectoryPage *FetchDirectoryPage();
+
+  /** @return the pinned bucket page */
+  Page *FetchBucketPage(page_id_t bucket_page_id);
+
+  /** @return the bucket page of the data of a page */
+  static BucketPage *ToBucketPage(Page *page) { return reinterpret_cast<BucketPage *>(page->GetData()); }
+
+  /** @return the next page of a bucket chain, pinned and latched, or nullptr after its last page */
+  Page *FetchNextChainPage(Page *page, bool exclusive);
+
+  /** Unlatches and unpins an overflow page of a bucket chain. */
+  void ReleaseChainPage(Page *page, bool exclusive, bool is_dirty);
+
+  /**
+   * Inserts a pair into the first page of a write latched bucket chain with room for it.
+   * @param[out] is_full set if the pair is not in the chain but no page has room for it
+   * @return true if insert succeeded
+   */
+  bool ChainInsert(Page *head, const KeyType &key, const ValueType &value, bool *is_full);
+
+  /** Appends a pair to a write latched bucket chain that does not hold it, growing the chain if it is full. */
+  void ChainAppend(Page *head, const KeyType &key, const ValueType &value);
+
+  /**
+   * Removes a pair from a write latched bucket chain, overflow pages it empties are dropped from the chain.
+   * @return true if remove succeeded
+   */
+  bool ChainRemove(Page *head, const KeyType &key, const ValueType &value);
+
+  /** Moves the pairs of a write latched bucket chain out, and drops its overflow pages. */
+  void ChainDrain(Page *head, std::vector<MappingType> *pairs);
+
+  /** @return the bits in which the hash of some key of a latched bucket chain differs from a hash */
+  uint32_t ChainHashDiff(Page *head, uint32_t hash);
+
+  /**
+   * Inserts a key-value pair under the table write latch, splitting the bucket of the key until the pair fits, or
+   * chaining an overflow page to it once no split can help.
+   * @return true if insert succeeded, false if the pair is already there
+   */
+  bool SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value);
+
+  /** Merges the bucket of a key with its split image while either is empty, then shrinks the directory. */
+  void Merge(Transaction *transaction, const KeyType &key);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes inserts and removes, writer is only split and merge
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -21,6 +22,7 @@
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 namespace bustub {
 class ExecutionEngine {
  public:
@@ -39,11 +41,23 @@ class ExecutionEngine {
 
     // execute
     try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr && tuple.GetLength() != 0) {
-          result_set->push_back(tuple);
+      if (executor->SupportsBatch()) {
+        // every operator of the plan produces whole batches, pull tuples a batch at a time
+        TupleBatch batch;
+        while (executor->NextBatch(&batch)) {
+          for (uint32_t i = 0; result_set != nullptr && i < batch.Size(); i++) {
+            if (batch.TupleAt(i).GetLength() != 0) {
+              result_set->push_back(std::move(batch.TupleAt(i)));
+            }
+          }
+        }
+      } else {
+        Tuple tuple;
+        RID rid;
+        while (executor->Next(&tuple, &rid)) {
+          if (result_set != nullptr && tuple.GetLength() != 0) {
+            result_set->push_back(tuple);
+          }
         }
       }
     } catch (Exception &e) {
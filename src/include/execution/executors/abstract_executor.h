@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <utility>
+
 #include "execution/executor_context.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 /**
- * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * AbstractExecutor implements the Volcano tuple-at-a-time iterator model, and optionally the batch-at-a-time model.
+ * After Init(), a consumer pulls tuples either with Next() or with NextBatch(), but does not mix the two.
  */
 class AbstractExecutor {
  public:
@@ -44,6 +48,24 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next batch of tuples from this executor. The default fills the batch by calling Next().
+   * @param[out] batch the next tuples produced by this executor, the batch is cleared first
+   * @return true if any tuple was produced, false if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && this->Next(&tuple, &rid)) {
+      batch->Append(std::move(tuple), rid);
+    }
+    return !batch->IsEmpty();
+  }
+
+  /** @return true if this executor and all of its children produce batches without falling back to Next() */
+  virtual bool SupportsBatch() { return false; }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
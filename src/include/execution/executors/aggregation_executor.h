@@ -172,6 +172,11 @@ class AggregationExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /** Fills the batch with the groups of the hash table that satisfy the HAVING clause. */
+  bool NextBatch(TupleBatch *batch) override;
+
+  bool SupportsBatch() override { return this->child_->SupportsBatch(); }
+
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -191,6 +196,12 @@ class AggregationExecutor : public AbstractExecutor {
   }
 
  private:
+  /**
+   * Produces the output tuple of a group if it satisfies the HAVING clause.
+   * @return true if the tuple was produced
+   */
+  bool produce(const AggregateKey &agg_key, const AggregateValue &agg_val, Tuple *tuple);
+
   /** The aggregation plan node. */
   const AggregationPlanNode *plan_;
   /** The child executor whose tuples we are aggregating. */
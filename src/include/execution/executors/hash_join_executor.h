@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+/**
+ * HashJoinExecutor executes an equi-join by building an in memory hash table on the join keys of the smaller child,
+ * and probing it with the tuples of the other child.
+ *
+ * If neither child fits in the memory budget of the plan, the join turns into a Grace hash join: both children are
+ * spilled to TmpTuplePages in HASH_JOIN_PARTITIONS partitions by the hash of their join keys, and each pair of
+ * partitions is joined in memory on its smaller side. A pair whose smaller side still does not fit is partitioned
+ * again with another hash, up to HASH_JOIN_MAX_DEPTH times, past which it is built in memory anyway since its keys are
+ * most likely all the same.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor that produces tuple for the left side of join
+   * @param right_executor the child executor that produces tuple for the right side of join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  /** Frees the pages of the partitions that were not joined. */
+  ~HashJoinExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /**
+   * Reads both children a batch at a time until one of them ends within the memory budget, and builds the hash table
+   * on that one. The tuples read from the other one are kept to be probed first. If both of them outgrow the budget
+   * first, spills both of them to partitions instead.
+   */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+ private:
+  /** @return the join key of a tuple */
+  HashJoinKey makeKey(const Tuple *tuple, const std::vector<const AbstractExpression *> &key_exprs,
+                      const Schema *schema) const {
+    std::vector<Value> keys;
+    keys.reserve(key_exprs.size());
+    for (const auto *expr : key_exprs) {
+      keys.emplace_back(expr->Evaluate(tuple, schema));
+    }
+    return {keys};
+  }
+
+  Tuple genJoinTuple(const Tuple *left_tuple, const Tuple *right_tuple, const Schema *left_schema,
+                     const Schema *right_schema) {
+    std::vector<Value> values;
+    for (auto &col : this->GetOutputSchema()->GetColumns()) {
+      try {
+        Value value = left_tuple->GetValue(left_schema, left_schema->GetColIdx(col.GetName()));
+        values.push_back(value);
+        continue;
+      } catch (std::logic_error &e) {
+        // do nothing
+      }
+      try {
+        Value value = right_tuple->GetValue(right_schema, right_schema->GetColIdx(col.GetName()));
+        values.push_back(value);
+        continue;
+      } catch (std::logic_error &e) {
+        // do nothing
+      }
+      UNREACHABLE("Column in GetOutputSchema does not exist");
+    }
+    return Tuple(values, this->GetOutputSchema());
+  }
+
+  /** A spilled partition of the tuples of one child, and their size on its pages. */
+  struct Partition {
+    std::vector<page_id_t> pages_;
+    size_t size_{0};
+  };
+
+  /** The partitions of both children whose tuples hash to the same partition at some depth. */
+  struct PartitionPair {
+    Partition left_;
+    Partition right_;
+    uint32_t depth_;
+  };
+
+  /**
+   * Pulls the next batch of a child and moves its tuples to the end of tuples, adding their spill sizes to size.
+   * @return false if the child has no more tuples
+   */
+  static bool appendBatch(AbstractExecutor *executor, TupleBatch *batch, std::vector<Tuple> *tuples, size_t *size);
+
+  /** @return the partition of a join key among the partitions of some depth */
+  static size_t partitionOf(const HashJoinKey &key, uint32_t depth) {
+    return HashUtil::CombineHashes(std::hash<HashJoinKey>()(key), depth) % HASH_JOIN_PARTITIONS;
+  }
+
+  /** @return the size of a tuple on a TmpTuplePage */
+  static size_t spillSize(const Tuple &tuple) { return sizeof(uint32_t) + tuple.GetLength(); }
+
+  /** Builds the hash table on the tuples of one side, moving them into it. */
+  void build(std::vector<Tuple> *build_tuples, bool build_left);
+
+  /** Spills the tuples read by Init and the rest of both children into the partitions of depth 1. */
+  void spill(std::vector<Tuple> *left_tuples, bool left_done, std::vector<Tuple> *right_tuples, bool right_done);
+
+  /**
+   * Appends a tuple to the partition of its key, among the partitions of one side at some depth.
+   * @param partitions the partitions of the side
+   * @param pages the pinned page of each partition that is filled now, or nullptr
+   */
+  void spillTuple(const Tuple &tuple, bool left, uint32_t depth, std::vector<Partition> *partitions,
+                  std::vector<Page *> *pages);
+
+  /** Unpins the pages being filled by spillTuple. */
+  void finishSpill(std::vector<Page *> *pages);
+
+  /**
+   * Reads the tuples of a page of a partition and deletes the page.
+   * @param page_id the page to read
+   * @param[out] tuples the tuples of the page are appended here
+   */
+  void readSpilledPage(page_id_t page_id, std::vector<Tuple> *tuples);
+
+  /** Deletes all the pages of a partition. */
+  void dropPartition(Partition *partition);
+
+  /** Deletes the pages of the partitions not joined yet, and of the probe partition not read yet. */
+  void dropSpilled();
+
+  /**
+   * Builds the hash table on the smaller side of the next pair of partitions, partitioning pairs again if needed.
+   * @return false if all the pairs are joined
+   */
+  bool joinNextPartition();
+
+  /**
+   * Moves the next tuple of the probe side into probe_tuple_.
+   * @return false if the probe side has no more tuples
+   */
+  bool nextProbeTuple();
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /* true if the hash table holds the left tuples, and the right ones probe it */
+  bool build_left_{true};
+  std::unordered_map<HashJoinKey, std::vector<Tuple>> ht_;
+  /* the probe tuples being joined, read from the probe child, or from the spilled probe partition page by page */
+  std::vector<Tuple> probe_buffer_;
+  size_t probe_buffer_position_{0};
+  TupleBatch probe_batch_;
+  bool probe_done_{false};
+  /* true if the children are spilled, the pairs of partitions left to join, and the probe pages left to read */
+  bool spilled_{false};
+  std::vector<PartitionPair> partitions_;
+  std::vector<page_id_t> probe_pages_;
+  size_t probe_page_position_{0};
+  /* the probe tuple being joined, the build tuples with its key, and the next one of them */
+  Tuple probe_tuple_;
+  const std::vector<Tuple> *matches_{nullptr};
+  size_t match_position_{0};
+};
+}  // namespace bustub
@@ -25,6 +25,9 @@ namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * A predicate comparing the column of a single column index with a constant bounds the range of keys scanned, the
+ * predicate is still evaluated on every tuple in that range.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -47,16 +50,18 @@ class IndexScanExecutor : public AbstractExecutor {
 
   Index *getIndex() const { return this->getIndexInfo()->index_.get(); }
 
-  IndexIterator<GenericKey<8>, RID, GenericComparator<8>> getBeginIterator() const {
-    return reinterpret_cast<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *>(this->getIndex())
-        ->GetBeginIterator();
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *getTreeIndex() const {
+    return reinterpret_cast<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *>(this->getIndex());
   }
 
-  IndexIterator<GenericKey<8>, RID, GenericComparator<8>> getEndIterator() const {
-    return reinterpret_cast<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *>(this->getIndex())
-        ->GetEndIterator();
+  IndexIterator<GenericKey<8>, RID, GenericComparator<8>> getBeginIterator(const GenericKey<8> *key,
+                                                                           const GenericKey<8> *end_key) const {
+    return this->getTreeIndex()->GetBeginIterator(key, end_key);
   }
 
+  /** Derive the range of keys to scan from the predicate, the whole index if it does not bound the key. */
+  void initKeyRange();
+
   TableHeap *getTableHeap() const {
     return this->exec_ctx_->GetCatalog()->GetTable(this->getIndexInfo()->table_name_)->table_.get();
   }
@@ -82,5 +87,10 @@ class IndexScanExecutor : public AbstractExecutor {
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
   IndexIterator<GenericKey<8>, RID, GenericComparator<8>> iter_;
+  // bounds of the keys to scan, both inclusive
+  GenericKey<8> low_key_;
+  bool has_low_key_{false};
+  GenericKey<8> high_key_;
+  bool has_high_key_{false};
 };
 }  // namespace bustub
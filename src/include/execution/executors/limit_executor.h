@@ -39,6 +39,10 @@ class LimitExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
+  bool SupportsBatch() override { return child_executor_->SupportsBatch(); }
+
  private:
   /** The limit plan node to be executed. */
   const LimitPlanNode *plan_;
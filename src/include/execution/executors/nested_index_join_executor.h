@@ -47,6 +47,10 @@ class NestIndexJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
+  bool SupportsBatch() override { return child_executor_->SupportsBatch(); }
+
  private:
   IndexInfo *getIndexInfo() const {
     std::string table_name = this->exec_ctx_->GetCatalog()->GetTable(this->plan_->GetInnerTableOid())->name_;
@@ -109,10 +113,21 @@ class NestIndexJoinExecutor : public AbstractExecutor {
     return Tuple(values, outputSchema);
   }
 
+  /**
+   * Pull the next batch of outer tuples from the child executor and look up all their keys in the inner index at once.
+   * @return false if the child executor has no more tuples
+   */
+  bool fetchOuterBatch();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
-  std::unique_ptr<Tuple> outer_tuple_;
+  /* outer tuples probed together, and the inner RIDs found for each of them */
+  TupleBatch outer_batch_{INDEX_JOIN_BATCH_SIZE};
+  std::vector<std::vector<RID>> inner_rids_;
+  /* next tuple of outer_batch_ to join, and the next of its inner RIDs */
+  size_t batch_position_{0};
+  size_t inner_position_{0};
   /* this iter_ used to travels inner table */
   IndexIterator<GenericKey<8>, RID, GenericComparator<8>> iter_;
 };
@@ -46,6 +46,10 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
+  bool SupportsBatch() override { return left_executor_->SupportsBatch() && right_executor_->SupportsBatch(); }
+
  private:
   Tuple genJoinTuple(Tuple *left_tuple, Tuple *right_tuple, const Schema *left_schema, const Schema *right_schema) {
     std::vector<Value> values;
@@ -74,5 +78,8 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> left_executor_;
   std::unique_ptr<AbstractExecutor> right_executor_;
   std::unique_ptr<Tuple> outer_tuple_;
+  /* inner tuples joined with outer_tuple_ by NextBatch, and the next one of them */
+  TupleBatch right_batch_;
+  uint32_t right_position_{0};
 };
 }  // namespace bustub
@@ -19,11 +19,13 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 
 /**
- * SeqScanExecutor executes a sequential scan over a table.
+ * SeqScanExecutor executes a sequential scan over a table. NextBatch reads the table a page at a time, each page
+ * under a single fetch and latch, into slots whose storage is reused from batch to batch.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -38,11 +40,21 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
+  bool SupportsBatch() override { return true; }
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
   Schema *getSchema() const { return &(this->exec_ctx_->GetCatalog()->GetTable(this->plan_->GetTableOid())->schema_); }
 
+  /**
+   * Locks a raw tuple as the isolation level needs, and produces its output tuple if it satisfies the predicate.
+   * @return true if the tuple was produced
+   */
+  bool produce(const Tuple *raw_tuple, const RID &rid, Tuple *tuple);
+
   Tuple genOutputTuple(const Tuple *raw_tuple, const Schema *schema, const Schema *outputSchema) {
     std::vector<Value> values;
     // generate new_tuple from raw_tuple through outputschema
@@ -63,5 +75,8 @@ class SeqScanExecutor : public AbstractExecutor {
   TableHeap *tableHeap_;
   // must use smart_ptr to avoid memory leak!!!
   std::unique_ptr<TableIterator> iter_;
+  /* the raw tuples read by NextBatch from the current page, and the next one of them */
+  TupleBatch raw_batch_;
+  uint32_t raw_position_{0};
 };
 }  // namespace bustub
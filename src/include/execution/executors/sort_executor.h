@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/util/loser_tree.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * SortExecutor is an external merge sort of the tuples of its child.
+ *
+ * Tuples are gathered in memory until they outgrow the memory budget of the plan, then sorted and spilled as a run, a
+ * list of TmpTuplePages. Once the child ends, the runs are merged with a loser tree, holding one page of tuples per
+ * run in memory. If there are more runs than pages in the budget, groups of them are merged into longer runs first.
+ * Pages are deleted as soon as they are read. If the whole input fits in the budget, nothing is spilled.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child_executor the child executor that produces the tuples to sort
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Frees the pages of the runs that were not read. */
+  ~SortExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  /** Reads the whole child, spilling sorted runs as needed, and starts their merge. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return how a orders against b, negative if before, 0 if equal, positive if after, null values order first */
+  static int CompareValues(const Value &a, const Value &b);
+
+  /** @return the number of runs spilled by the last Init, including the ones written by intermediate merges */
+  size_t GetNumSpilledRuns() const { return num_spilled_runs_; }
+
+ private:
+  /** A tuple and its sort keys. */
+  struct SortEntry {
+    std::vector<Value> keys_;
+    Tuple tuple_;
+  };
+
+  /** Read position in a run being merged, the tuples of its current page are held in memory. */
+  struct RunReader {
+    std::vector<page_id_t> pages_;
+    size_t page_position_{0};
+    std::vector<SortEntry> entries_;
+    size_t position_{0};
+  };
+
+  /** @return the size of a tuple on a TmpTuplePage */
+  static size_t spillSize(const Tuple &tuple) { return sizeof(uint32_t) + tuple.GetLength(); }
+
+  /** @return the tuple with its sort keys */
+  SortEntry makeEntry(Tuple &&tuple) const {
+    std::vector<Value> keys;
+    keys.reserve(this->plan_->GetOrderBys().size());
+    for (const auto &order_by : this->plan_->GetOrderBys()) {
+      keys.emplace_back(order_by.second->Evaluate(&tuple, this->child_executor_->GetOutputSchema()));
+    }
+    return {std::move(keys), std::move(tuple)};
+  }
+
+  /** @return true if a orders strictly before b */
+  bool less(const SortEntry &a, const SortEntry &b) const;
+
+  /** Sorts the tuples in memory and spills them as a run. */
+  void spillRun(std::vector<SortEntry> *entries);
+
+  /**
+   * Appends a tuple to a run.
+   * @param run the pages of the run
+   * @param page the pinned last page of the run, or nullptr
+   */
+  void appendToRun(const Tuple &tuple, std::vector<page_id_t> *run, Page **page);
+
+  /** Reads the next page of the run of a reader once the tuples it holds are consumed, and deletes the page. */
+  void fillReader(RunReader *reader);
+
+  /** Starts merging the first num_runs runs. */
+  void startMerge(size_t num_runs);
+
+  /** @return true if the head of reader i orders before the head of reader j, exhausted readers order last */
+  bool readerLess(size_t i, size_t j) const {
+    const RunReader &a = this->readers_[i];
+    const RunReader &b = this->readers_[j];
+    if (a.position_ == a.entries_.size()) {
+      return false;
+    }
+    if (b.position_ == b.entries_.size()) {
+      return true;
+    }
+    if (this->less(a.entries_[a.position_], b.entries_[b.position_])) {
+      return true;
+    }
+    return !this->less(b.entries_[b.position_], a.entries_[a.position_]) && i < j;
+  }
+
+  /** Moves the next tuple of the merge into entry. @return false once the runs are consumed */
+  bool mergeNext(SortEntry *entry);
+
+  /** Deletes the pages of the runs, and of the runs being merged, not read yet. */
+  void dropRuns();
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /* the sorted tuples when nothing was spilled, and the next one of them */
+  std::vector<SortEntry> entries_;
+  size_t position_{0};
+  /* the runs not merged yet, in the order they were written */
+  std::deque<std::vector<page_id_t>> runs_;
+  size_t num_spilled_runs_{0};
+  /* true once the tuples come from a merge of the runs, the runs being merged, and the tournament between them */
+  bool merging_{false};
+  std::vector<RunReader> readers_;
+  LoserTree tree_;
+};
+}  // namespace bustub
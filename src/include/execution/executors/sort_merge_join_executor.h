@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_executor.h
+//
+// Identification: src/include/execution/executors/sort_merge_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/plans/sort_merge_join_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+/**
+ * SortMergeJoinExecutor executes an equi-join by reading both children in the ascending order of their join keys and
+ * merging them. A child not declared sorted by the plan is sorted first by a SortExecutor, spilling to disk as needed.
+ *
+ * Only the right tuples sharing the key of the current left tuple are held in memory, and joined with every left tuple
+ * having that key. Tuples with a null join key match nothing and are skipped.
+ */
+class SortMergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort-merge join executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort-merge join plan to be executed
+   * @param left_executor the child executor that produces tuple for the left side of join
+   * @param right_executor the child executor that produces tuple for the right side of join
+   */
+  SortMergeJoinExecutor(ExecutorContext *exec_ctx, const SortMergeJoinPlanNode *plan,
+                        std::unique_ptr<AbstractExecutor> &&left_executor,
+                        std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+ private:
+  /** The read position in one child, and its current tuple with its join keys. */
+  struct JoinSide {
+    std::unique_ptr<AbstractExecutor> executor_;
+    const std::vector<const AbstractExpression *> *key_exprs_;
+    TupleBatch batch_;
+    uint32_t batch_position_{0};
+    bool has_tuple_{false};
+    Tuple tuple_;
+    std::vector<Value> keys_;
+  };
+
+  /** @return the child executor wrapped in a SortExecutor ascending on its join keys, with the plan of the sort */
+  std::unique_ptr<AbstractExecutor> sorted(std::unique_ptr<AbstractExecutor> &&executor, const AbstractPlanNode *plan,
+                                           const std::vector<const AbstractExpression *> &key_exprs,
+                                           std::unique_ptr<SortPlanNode> *sort_plan);
+
+  /** Moves a side to its next tuple whose join keys are not null, has_tuple_ is false once the child ends. */
+  void advance(JoinSide *side);
+
+  /** @return how join keys a order against join keys b, negative if before, 0 if equal, positive if after */
+  static int compareKeys(const std::vector<Value> &a, const std::vector<Value> &b) {
+    for (size_t i = 0; i < a.size(); i++) {
+      int cmp = SortExecutor::CompareValues(a[i], b[i]);
+      if (cmp != 0) {
+        return cmp;
+      }
+    }
+    return 0;
+  }
+
+  Tuple genJoinTuple(const Tuple *left_tuple, const Tuple *right_tuple, const Schema *left_schema,
+                     const Schema *right_schema) {
+    std::vector<Value> values;
+    for (auto &col : this->GetOutputSchema()->GetColumns()) {
+      try {
+        Value value = left_tuple->GetValue(left_schema, left_schema->GetColIdx(col.GetName()));
+        values.push_back(value);
+        continue;
+      } catch (std::logic_error &e) {
+        // do nothing
+      }
+      try {
+        Value value = right_tuple->GetValue(right_schema, right_schema->GetColIdx(col.GetName()));
+        values.push_back(value);
+        continue;
+      } catch (std::logic_error &e) {
+        // do nothing
+      }
+      UNREACHABLE("Column in GetOutputSchema does not exist");
+    }
+    return Tuple(values, this->GetOutputSchema());
+  }
+
+  /** The sort-merge join plan node to be executed. */
+  const SortMergeJoinPlanNode *plan_;
+  /* the plans of the sorts wrapping the children not sorted yet, or nullptr */
+  std::unique_ptr<SortPlanNode> left_sort_plan_;
+  std::unique_ptr<SortPlanNode> right_sort_plan_;
+  JoinSide left_;
+  JoinSide right_;
+  /* the right tuples whose keys equal the keys of the current left tuple, and the next one of them */
+  std::vector<Tuple> group_;
+  std::vector<Value> group_keys_;
+  size_t group_position_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_executor.h
+//
+// Identification: src/include/execution/executors/top_n_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/top_n_plan.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+/**
+ * TopNExecutor produces the first tuples of its child in the order of the plan in a single pass over the child.
+ *
+ * It keeps the offset + limit tuples ordering first so far in a max-heap, whose top is the last of them, and replaces
+ * the top whenever a child tuple orders before it. Memory stays bounded by offset + limit tuples however long the child
+ * is. Tuples with equal sort keys keep the order of the child, as after a SortExecutor.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new top-n executor.
+   * @param exec_ctx the executor context
+   * @param plan the top-n plan to be executed
+   * @param child_executor the child executor that produces the tuples to order
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  /** Reads the whole child, keeping its first offset + limit tuples, and skips the first offset of them. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+ private:
+  /** A tuple, its sort keys, and its position in the child. */
+  struct TopNEntry {
+    std::vector<Value> keys_;
+    size_t sequence_;
+    Tuple tuple_;
+  };
+
+  /** @return true if a orders strictly before b, the one read first if their keys are equal */
+  bool less(const TopNEntry &a, const TopNEntry &b) const;
+
+  /** The top-n plan node to be executed. */
+  const TopNPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /* the kept tuples, a max-heap while the child is read and then sorted, and the next one of them */
+  std::vector<TopNEntry> entries_;
+  size_t position_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_plan.h
+//
+// Identification: src/include/execution/plans/hash_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * HashJoinPlanNode is used to represent performing an equi-join between two children plan nodes.
+ * The tuples are joined if their join keys are equal and the predicate, if any, evaluates to true.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new hash join plan node.
+   * @param output_schema the output format of this hash join node
+   * @param children the left and the right children plans
+   * @param predicate the predicate checked on top of the equal join keys, or nullptr
+   * @param left_hash_keys the join key expressions on the left child tuples
+   * @param right_hash_keys the join key expressions on the right child tuples
+   * @param memory_pages the pages of tuples the hash table may hold, the join spills to disk beyond that
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   const AbstractExpression *predicate, std::vector<const AbstractExpression *> &&left_hash_keys,
+                   std::vector<const AbstractExpression *> &&right_hash_keys,
+                   size_t memory_pages = HASH_JOIN_MEMORY_PAGES)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        predicate_(predicate),
+        left_hash_keys_(std::move(left_hash_keys)),
+        right_hash_keys_(std::move(right_hash_keys)),
+        memory_pages_(memory_pages) {
+    BUSTUB_ASSERT(left_hash_keys_.size() == right_hash_keys_.size(), "Both sides need the same number of join keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return the predicate checked on top of the equal join keys, or nullptr */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the join key expressions on the left child tuples */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_hash_keys_; }
+
+  /** @return the join key expressions on the right child tuples */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_hash_keys_; }
+
+  /** @return the pages of tuples the hash table may hold */
+  size_t GetMemoryPages() const { return memory_pages_; }
+
+  /** @return the left plan node of the hash join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the hash join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  /** The join predicate. */
+  const AbstractExpression *predicate_;
+  /** The join keys of the left and the right tuples. */
+  std::vector<const AbstractExpression *> left_hash_keys_;
+  std::vector<const AbstractExpression *> right_hash_keys_;
+  /** The memory budget of the hash table, in pages. */
+  size_t memory_pages_;
+};
+
+struct HashJoinKey {
+  std::vector<Value> keys_;
+
+  /** @return true if any of the join keys is null, such a key matches no other key */
+  bool HasNull() const {
+    for (const auto &key : keys_) {
+      if (key.IsNull()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Compares two hash join keys for equality.
+   * @param other the other hash join key to be compared with
+   * @return true if both hash join keys have equivalent values, false otherwise
+   */
+  bool operator==(const HashJoinKey &other) const {
+    for (uint32_t i = 0; i < other.keys_.size(); i++) {
+      if (keys_[i].CompareEquals(other.keys_[i]) != CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace bustub
+
+namespace std {
+
+/**
+ * Implements std::hash on HashJoinKey.
+ */
+template <>
+struct hash<bustub::HashJoinKey> {
+  std::size_t operator()(const bustub::HashJoinKey &join_key) const {
+    size_t curr_hash = 0;
+    for (const auto &key : join_key.keys_) {
+      if (!key.IsNull()) {
+        curr_hash = bustub::HashUtil::CombineHashes(curr_hash, bustub::HashUtil::HashValue(&key));
+      }
+    }
+    return curr_hash;
+  }
+};
+
+}  // namespace std
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_plan.h
+//
+// Identification: src/include/execution/plans/sort_merge_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * SortMergeJoinPlanNode is used to represent performing an equi-join between two children plan nodes by merging them
+ * in the order of their join keys. The tuples are joined if their join keys are equal and the predicate, if any,
+ * evaluates to true.
+ *
+ * A child already sorted ascending on its join keys, e.g. an index scan over an index on them, is declared so and is
+ * not sorted again.
+ */
+class SortMergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort-merge join plan node.
+   * @param output_schema the output format of this sort-merge join node
+   * @param children the left and the right children plans
+   * @param predicate the predicate checked on top of the equal join keys, or nullptr
+   * @param left_keys the join key expressions on the left child tuples
+   * @param right_keys the join key expressions on the right child tuples
+   * @param left_sorted true if the left child produces its tuples sorted ascending on the left join keys
+   * @param right_sorted true if the right child produces its tuples sorted ascending on the right join keys
+   */
+  SortMergeJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                        const AbstractExpression *predicate, std::vector<const AbstractExpression *> &&left_keys,
+                        std::vector<const AbstractExpression *> &&right_keys, bool left_sorted = false,
+                        bool right_sorted = false)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        predicate_(predicate),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        left_sorted_(left_sorted),
+        right_sorted_(right_sorted) {
+    BUSTUB_ASSERT(left_keys_.size() == right_keys_.size(), "Both sides need the same number of join keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::SortMergeJoin; }
+
+  /** @return the predicate checked on top of the equal join keys, or nullptr */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the join key expressions on the left child tuples */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the join key expressions on the right child tuples */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+  /** @return true if the left child produces its tuples sorted on the left join keys */
+  bool IsLeftSorted() const { return left_sorted_; }
+
+  /** @return true if the right child produces its tuples sorted on the right join keys */
+  bool IsRightSorted() const { return right_sorted_; }
+
+  /** @return the left plan node of the sort-merge join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Sort-merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the sort-merge join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Sort-merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  /** The join predicate. */
+  const AbstractExpression *predicate_;
+  /** The join keys of the left and the right tuples. */
+  std::vector<const AbstractExpression *> left_keys_;
+  std::vector<const AbstractExpression *> right_keys_;
+  /** Whether each child is already sorted on its join keys. */
+  bool left_sorted_;
+  bool right_sorted_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction a sort key orders the tuples in. */
+enum class OrderByType { ASC, DESC };
+
+/**
+ * SortPlanNode orders the tuples of its child by a list of sort keys, the first key first. Null keys order first in
+ * ascending order.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort plan node that has a child plan.
+   * @param output_schema the output format of this sort node, the one of its child
+   * @param child the child plan to obtain tuples from
+   * @param order_bys the direction and the expression of each sort key
+   * @param memory_pages the pages of tuples sorted in memory, longer inputs are sorted in runs spilled to disk
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys,
+               size_t memory_pages = EXTERNAL_SORT_BUFFER_PAGES)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), memory_pages_(memory_pages) {}
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return the direction and the expression of each sort key */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  /** @return the pages of tuples sorted in memory */
+  size_t GetMemoryPages() const { return memory_pages_; }
+
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The sort keys. */
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  /** The memory budget of the sort, in pages. */
+  size_t memory_pages_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_plan.h
+//
+// Identification: src/include/execution/plans/top_n_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/sort_plan.h"
+
+namespace bustub {
+/**
+ * TopN is a sort followed by a limit: it orders the tuples of its child by a list of sort keys like a SortPlanNode,
+ * skips offset of them and produces the next limit ones.
+ */
+class TopNPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new top-n plan node that has a child plan.
+   * @param output_schema the output format of this top-n node, the one of its child
+   * @param child the child plan to obtain tuples from
+   * @param order_bys the direction and the expression of each sort key
+   * @param limit the number of output tuples
+   * @param offset the number of rows to be skipped
+   */
+  TopNPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys, size_t limit, size_t offset)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), limit_(limit), offset_(offset) {}
+
+  PlanType GetType() const override { return PlanType::TopN; }
+
+  /** @return the direction and the expression of each sort key */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  size_t GetLimit() const { return limit_; }
+
+  size_t GetOffset() const { return offset_; }
+
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "TopN should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The sort keys. */
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  size_t limit_;
+  size_t offset_;
+};
+}  // namespace bustub
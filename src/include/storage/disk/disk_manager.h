@@ -15,25 +15,52 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/io_uring.h"
 
 namespace bustub {
 
+/** How the DiskManager does the I/O on the database file. */
+enum class DiskIOBackend {
+  /** pread/pwrite, one system call per I/O. */
+  PREAD,
+  /** io_uring for batched reads, all the I/Os of a batch are submitted with one system call. Falls back to PREAD if
+     the kernel does not support io_uring. Single page reads and writes still use pread/pwrite. */
+  IO_URING
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The database file is a sequence of block groups. Each group starts with a free-space map page, a bitmap with one bit
+ * per page of the group telling whether the page is allocated, followed by the PAGES_PER_MAP data pages it covers.
+ * Page ids only number the data pages, so they stay dense and the map pages are invisible to the rest of the system.
+ * The maps are kept in memory and written through on every change, which lets freed pages be reused and the
+ * allocation state survive a restart.
  */
 class DiskManager {
  public:
+  /** Number of pages covered by one free-space map page. */
+  static constexpr page_id_t PAGES_PER_MAP = PAGE_SIZE * 8;
+
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param backend how to do the I/O on the database file
+   * @param direct_io true to open the database file with O_DIRECT and bypass the OS page cache, which would otherwise
+   * keep a second copy of the pages cached by the buffer pool. Buffers that are not aligned for direct I/O go through
+   * a bounce buffer. Falls back to buffered I/O if the file system does not support O_DIRECT.
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, DiskIOBackend backend = DiskIOBackend::PREAD,
+                       bool direct_io = false);
 
-  ~DiskManager() = default;
+  ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -54,6 +81,21 @@ class DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Read several pages from the database file. Each run of consecutive page ids is read with a single vectored I/O,
+   * and with the io_uring backend all the I/Os are in flight at once.
+   * @param page_ids ids of the pages
+   * @param[out] page_data output buffers, one per page
+   * @return for each page, false if an I/O error kept it from being read
+   */
+  std::vector<bool> ReadPages(const std::vector<page_id_t> &page_ids, const std::vector<char *> &page_data);
+
+  /** @return the backend actually used for the database file */
+  DiskIOBackend GetBackend() const { return backend_; }
+
+  /** @return true if the database file is actually accessed with O_DIRECT */
+  bool IsDirectIO() const { return direct_io_; }
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -71,17 +113,39 @@ class DiskManager {
   bool ReadLog(char *log_data, int size, int offset);
 
   /**
-   * Allocate a page on disk.
+   * Allocate a page on disk. Freed pages are reused first, lowest page id first, before the file grows.
    * @return the id of the allocated page
    */
   page_id_t AllocatePage();
 
   /**
-   * Deallocate a page on disk.
+   * Allocate a run of consecutive pages on disk, so that they are also contiguous in the file and can be read and
+   * written sequentially. An extent never spans two block groups.
+   * @param num_pages number of pages in the extent, at most PAGES_PER_MAP
+   * @return the id of the first page of the extent, or INVALID_PAGE_ID if num_pages is out of range
+   */
+  page_id_t AllocateExtent(int num_pages);
+
+  /**
+   * Deallocate a page on disk, so that it can be allocated again.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(page_id_t page_id);
 
+  /**
+   * @param page_id id of the page
+   * @return true if the page is allocated
+   */
+  bool IsAllocated(page_id_t page_id);
+
+  /**
+   * Write the map pages changed since the last flush. Allocations and deallocations only change the in-memory maps,
+   * they reach the file on a flush, which BufferPoolManager::FlushAllPages and ShutDown do. A crash forgets the changes
+   * made since the last flush, like it forgets pages that were not flushed.
+   * @return false if a map page could not be written, it is then written again by the next flush
+   */
+  bool FlushFreeSpaceMap();
+
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
 
@@ -91,6 +155,12 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return one past the highest allocated page id, every allocated page id is below it */
+  page_id_t GetNumPages() const;
+
+  /** @return the number of disk reads, a batched read of several pages counts once */
+  int GetNumReads() const;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -101,16 +171,58 @@ class DiskManager {
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
  private:
+  /** @return the offset of the page in the database file, past the map pages of its group and the groups before */
+  static off_t PageOffset(page_id_t page_id) {
+    return (static_cast<off_t>(page_id / PAGES_PER_MAP) * (PAGES_PER_MAP + 1) + 1 + page_id % PAGES_PER_MAP) *
+           PAGE_SIZE;
+  }
+  /** @return the offset of the map page of a block group in the database file */
+  static off_t MapOffset(size_t group) { return static_cast<off_t>(group) * (PAGES_PER_MAP + 1) * PAGE_SIZE; }
+
+  /** @return false on an I/O error, see ReadPage */
+  bool ReadPageChecked(page_id_t page_id, char *page_data);
+
+  /** Reads the map pages of the database file and rebuilds the allocation state from them. */
+  void LoadFreeSpaceMap();
+  /** @return the first page of the first run of num_pages free pages within one group, allocation_latch_ held */
+  page_id_t FindFreeExtent(int num_pages);
+  /** Marks a run of pages of one group allocated or free in its in-memory map page, allocation_latch_ held */
+  void SetAllocated(page_id_t page_id, int num_pages, bool allocated);
+  /** @return true if the page is allocated, allocation_latch_ held */
+  bool IsAllocatedLocked(page_id_t page_id) const;
+
   int GetFileSize(const std::string &file_name);
+  /** @return true if the buffer can be used for I/O on db_fd_ as is */
+  bool IsAligned(const char *data) const {
+    return !direct_io_ || reinterpret_cast<uintptr_t>(data) % direct_io_alignment_ == 0;
+  }
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // file descriptor of the db file, only accessed with positional I/O so that threads share no file cursor
+  int db_fd_;
+  DiskIOBackend backend_;
+  // true if db_fd_ was opened with O_DIRECT, all its I/O buffers must then be aligned to direct_io_alignment_
+  bool direct_io_;
+  size_t direct_io_alignment_;
+  // io_uring instance for batched reads, nullptr with the PREAD backend
+  std::unique_ptr<IoUring> io_uring_;
+  // io_uring_ has a single submission queue
+  std::mutex io_uring_latch_;
   std::string file_name_;
+  // one past the highest allocated page id
   std::atomic<page_id_t> next_page_id_;
+  // protects the free-space maps and first_free_hint_
+  std::mutex allocation_latch_;
+  // in-memory copy of the map page of each block group
+  std::vector<std::vector<char>> free_space_maps_;
+  // true for the map pages changed since they were last written
+  std::vector<bool> dirty_maps_;
+  // no page below it is free
+  page_id_t first_free_hint_{0};
   int num_flushes_;
-  int num_writes_;
+  std::atomic<int> num_writes_;
+  std::atomic<int> num_reads_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
 };
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_uring.h
+//
+// Identification: src/include/storage/disk/io_uring.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <vector>
+
+// defined in <linux/io_uring.h>, which is only included where the rings are driven
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * IoUring is a minimal wrapper around a Linux io_uring instance, driven through the raw system calls so that it does
+ * not need liburing. It submits a batch of vectored reads or writes with a single system call and reaps their
+ * completions straight from the shared completion queue.
+ *
+ * An IoUring is not thread-safe, callers serialize access to it.
+ */
+class IoUring {
+ public:
+  /** One vectored read or write of a batch. */
+  struct Request {
+    /** Buffers to read into or write from. */
+    const struct iovec *iov_;
+    /** Number of buffers. */
+    int iov_count_;
+    /** Offset in the file. */
+    off_t offset_;
+    /** Number of bytes transferred, or -errno on failure. Set by SubmitAndWait. */
+    int64_t result_;
+  };
+
+  /**
+   * Creates a new io_uring instance.
+   * @param entries the depth of the submission queue, batches larger than this are split
+   */
+  explicit IoUring(unsigned entries);
+
+  ~IoUring();
+
+  /** @return true if the kernel set up the ring, false if io_uring is not available */
+  bool IsValid() const { return ring_fd_ >= 0; }
+
+  /**
+   * Submits all the requests and waits for them to complete. Requests the kernel refuses to take fail with the error
+   * of io_uring_enter, the ones it took are always reaped before returning.
+   * @param fd the file to read or write
+   * @param write true to write the buffers, false to read into them
+   * @param[in,out] requests the requests, their result_ is set on return
+   */
+  void SubmitAndWait(int fd, bool write, std::vector<Request> *requests);
+
+ private:
+  void Unmap();
+
+  int ring_fd_{-1};
+  unsigned sq_entries_{0};
+
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  ::io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  // pointers into the shared rings
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  ::io_uring_cqe *cqes_{nullptr};
+};
+
+}  // namespace bustub
@@ -10,6 +10,9 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <queue>
 #include <set>
 #include <string>
@@ -19,6 +22,7 @@
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
@@ -29,7 +33,8 @@ namespace bustub {
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, unless the tree is created non-unique: then the values
+ * of a duplicate key are kept in a posting list
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -49,8 +54,12 @@ class BPlusTree {
   enum class LockType { READ, WRITE };
   enum class OpType { GET, INSERT, REMOVE };
 
+  /**
+   * @param unique true to reject the pairs whose key is already in the tree, false to keep every value of a key
+   */
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool unique = true);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -61,12 +70,45 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove a key & value pair from this B+ tree, the other values of the key stay.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // return the values associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  /**
+   * Look up a batch of keys. The keys are visited in sorted order: all the keys that fall in one leaf are looked up in
+   * a single copy of it, and the next leaf is reached from its lowest ancestor already copied that still covers the
+   * key, instead of from the root.
+   * @param keys the keys, in any order
+   * @param[out] results one vector per key in the order of keys, with the value of the key, or empty if it is missing
+   * @return the number of keys found
+   */
+  size_t GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                   Transaction *transaction = nullptr);
+
+  /**
+   * Build the tree bottom-up from key & value pairs given in any order, instead of inserting them one at a time.
+   * The pairs are sorted first, externally if they do not fit in memory. The leaves are then filled left to right up to
+   * the fill factor, and every level of internal pages is built the same way on top of the one below, so each page is
+   * written once. Of pairs with equal keys, only one is kept in a unique tree. The tree must be empty and nobody else
+   * may use it until this returns.
+   * @param next yields the next pair, returns false once all of them were given
+   * @param fill_factor fraction of each page to fill, the rest is left free for later inserts
+   * @param sort_buffer_pages pages worth of pairs sorted in memory at once
+   */
+  void BulkLoad(const std::function<bool(MappingType *)> &next, double fill_factor = BULK_LOAD_FILL_FACTOR,
+                int sort_buffer_pages = EXTERNAL_SORT_BUFFER_PAGES);
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
+  /**
+   * @param key the first key to visit, nullptr to start from the left most key
+   * @param end_key the last key to visit, nullptr to go on up to the right most key
+   * @return an iterator over the pairs with keys in [key, end_key]
+   */
+  INDEXITERATOR_TYPE Begin(const KeyType *key, const KeyType *end_key);
   INDEXITERATOR_TYPE end();
 
   void Print(BufferPoolManager *bpm) {
@@ -119,6 +161,64 @@ class BPlusTree {
 
   bool AdjustRoot(BPlusTreePage *node);
 
+  /**
+   * Remove a value of a key, or every value of it when value is nullptr. Only the last value of a key changes the
+   * structure of the tree.
+   */
+  void RemoveValue(const KeyType &key, const ValueType *value, Transaction *transaction);
+
+  /**
+   * Add a value to a key that is already in the write latched leaf, turning its value into a posting list if needed.
+   * @param old_value the value of the key in the leaf
+   * @return false if the tree is unique, or if the key already has the value
+   */
+  bool InsertIntoPostingList(LeafPage *leaf, const KeyType &key, const ValueType &old_value, const ValueType &value);
+
+  /**
+   * Remove a value from the posting list of a key of the write latched leaf. The key gets its value back from the
+   * posting list once there is only one left.
+   * @param old_value the value of the key in the leaf, a posting list marker
+   */
+  void RemoveFromPostingList(LeafPage *leaf, const KeyType &key, const ValueType &old_value, const ValueType &value);
+
+  /** Delete every page of a posting list that is no longer reachable from a leaf. */
+  void DeletePostingList(page_id_t page_id);
+
+  /** @return true if the value of a key is a posting list marker rather than a value */
+  bool IsPostingList(const ValueType &value) const {
+    return !this->unique_ && BPlusTreePostingPage::IsPostingList(value);
+  }
+
+  /** The page being filled at one level of a bulk load. */
+  struct BulkLoadLevel {
+    // pinned page being filled
+    Page *page_{nullptr};
+    // smallest key in the subtree of page_
+    KeyType first_key_;
+    // the page filled before page_ at this level, INVALID_PAGE_ID while page_ is the first one
+    page_id_t prev_page_id_{INVALID_PAGE_ID};
+  };
+
+  /**
+   * Append a child to the internal page being filled at a level, starting a new page once it holds internal_fill
+   * children.
+   * @return the id of the page the child was appended to
+   */
+  page_id_t BulkLoadAppend(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &key,
+                           page_id_t child_page_id, int internal_fill);
+
+  /** Append the page being filled at a level to the level above, and unpin it. */
+  void BulkLoadFinishPage(std::vector<BulkLoadLevel> *levels, size_t level, int internal_fill);
+
+  /**
+   * Bring the last page of a level up to its min size, by merging it into its left sibling or moving entries over
+   * from it. The left sibling is already in the level above, and keeps its first key either way.
+   * @return false if the last page was merged away
+   */
+  bool BulkLoadFixLastPage(std::vector<BulkLoadLevel> *levels, size_t level);
+
+  Page *BulkLoadNewPage(page_id_t *page_id);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -128,6 +228,63 @@ class BPlusTree {
 
   Page *getFindLeafPageWithLock(const KeyType &key, bool leftMost);
 
+  /**
+   * Copy the leaf page that should contain the key, without latching any page and without pinning the resident ones.
+   * Every page is copied, then validated against its version. The parent is validated again once the version of the
+   * child is read, so the child was still linked to the parent at that point.
+   * @param key the key to look for
+   * @param leftMost true to find the left most leaf page instead
+   * @param[out] leaf_data buffer of PAGE_SIZE bytes, receives the leaf page
+   * @param[out] leaf_page_id id of the leaf page, INVALID_PAGE_ID if the tree is empty
+   * @return false if a concurrent writer got in the way and the descent has to be retried
+   */
+  bool OptimisticFindLeafPage(const KeyType &key, bool leftMost, char *leaf_data, page_id_t *leaf_page_id);
+
+  /** A page copied on the way down of an optimistic descent that may be reused for the next keys. */
+  struct OptimisticPathLevel {
+    alignas(std::max_align_t) char data_[PAGE_SIZE];
+    // the frame the page was copied from, and the version of the page then
+    Page *page_;
+    uint64_t version_;
+    // the keys of the subtree of the page are below upper_, unless has_upper_ is false
+    bool has_upper_;
+    KeyType upper_;
+  };
+
+  /**
+   * Copy the path down to the leaf page that should contain the key, like OptimisticFindLeafPage. The path left by the
+   * previous key is kept down to the lowest page that covers the key and was not changed since, and the descent starts
+   * from there. Keys must come in ascending order.
+   * @param key the key to look for
+   * @param[in,out] path the pages copied from the root down to the leaf, empty if the tree is empty
+   * @return false if a concurrent writer got in the way, the path is then cleared
+   */
+  bool OptimisticFindLeafPath(const KeyType &key, std::vector<OptimisticPathLevel> *path);
+
+  /**
+   * Copy a page for an optimistic descent. A page that is not resident is read in and copied under its read latch.
+   * @param page_id id of the page
+   * @param[out] data buffer of PAGE_SIZE bytes, receives the page
+   * @param[out] page the frame the page was copied from, to validate it again later
+   * @param[out] version the version of the page when it was copied
+   * @return false if the copy is not consistent
+   */
+  bool OptimisticReadPage(page_id_t page_id, char *data, Page **page, uint64_t *version);
+
+  /**
+   * Find the leaf page that should contain the key and write latch it, with only read latches on the internal pages.
+   * The parent stays read latched while the leaf latch is upgraded, so nobody splits or merges the leaf meanwhile.
+   * @param key the key to look for
+   * @return the write latched and pinned leaf page, nullptr if the root is a leaf or the pages could not be fetched
+   */
+  Page *optimisticFindLeafPageWithLock(const KeyType &key);
+
+  /**
+   * Find the leaf page that should contain the key with latch crabbing, for an index iterator.
+   * @return the read latched and pinned leaf page, nullptr if the tree is empty
+   */
+  Page *findIteratorLeafPage(const KeyType &key, bool leftMost);
+
   Page *insertFindLeafPageWithLock(const KeyType &key, Transaction *transaction);
 
   Page *removeFindLeafPageWithLock(const KeyType &key, Transaction *transaction);
@@ -174,11 +331,13 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // read by optimistic readers without latch_
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool unique_;
   ReaderWriterLatch latch_;
 };
 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -27,16 +28,36 @@ class BPlusTreeIndex : public Index {
  public:
   BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
 
+  /** Set the index key of a key tuple, encoded the way the comparator of the index reads it. */
+  void SetIndexKey(const Tuple &key, KeyType *index_key) const;
+
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  /**
+   * Build the empty index bottom-up from entries given in any order, much faster than inserting them one by one.
+   * @param next yields the key and the value of the next entry, returns false once all of them were given
+   * @param fill_factor fraction of each page to fill
+   */
+  void BulkLoad(const std::function<bool(Tuple *, ValueType *)> &next, double fill_factor = BULK_LOAD_FILL_FACTOR);
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
+  /**
+   * @param key the lowest key of the range, nullptr for no lower bound
+   * @param end_key the highest key of the range, nullptr for no upper bound
+   * @return an iterator over the entries with keys in [key, end_key]
+   */
+  INDEXITERATOR_TYPE GetBeginIterator(const KeyType *key, const KeyType *end_key);
+
   INDEXITERATOR_TYPE GetEndIterator();
 
  protected:
@@ -0,0 +1,276 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.h
+//
+// Identification: src/include/storage/index/external_sorter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+/**
+ * ExternalSorter sorts fixed-size records that may not fit in memory.
+ *
+ * Records are buffered in memory and every full buffer is sorted and spilled as a run, a chain of temporary pages of
+ * the buffer pool. Once all the records are added, the runs are merged with one pinned page per run. If there are
+ * more runs than half of the buffer pool, groups of them are merged into longer runs first, and the final merge
+ * streams the records out in order. Temporary pages are deleted as soon as they are consumed, so that their space on
+ * disk is reused. If all the records fit in the buffer, nothing is spilled.
+ *
+ * Records are stored in the pages as is, like the pairs of the B+ tree pages, so they must not own any memory.
+ */
+template <typename RecordType, typename Less>
+class ExternalSorter {
+  /** Layout of a page of a run. */
+  struct RunPage {
+    // next page of the run, INVALID_PAGE_ID on the last page
+    page_id_t next_page_id_;
+    // number of records in this page
+    int size_;
+    RecordType records_[0];
+  };
+
+ public:
+  /** Number of records in a page of a run. */
+  static constexpr int RECORDS_PER_PAGE = (PAGE_SIZE - sizeof(RunPage)) / sizeof(RecordType);
+
+  /**
+   * Creates a new external sorter.
+   * @param buffer_pool_manager buffer pool manager for the pages of the runs
+   * @param less strict weak ordering of the records
+   * @param buffer_pages pages worth of records sorted in memory, each spilled run is that long
+   */
+  ExternalSorter(BufferPoolManager *buffer_pool_manager, Less less, int buffer_pages = EXTERNAL_SORT_BUFFER_PAGES)
+      : buffer_pool_manager_(buffer_pool_manager),
+        less_(std::move(less)),
+        buffer_size_(static_cast<size_t>(std::max(buffer_pages, 1)) * RECORDS_PER_PAGE) {}
+
+  ~ExternalSorter() {
+    for (size_t cursor : heap_) {
+      page_id_t pageID = cursors_[cursor].page_->GetPageId();
+      page_id_t nextPageID = Records(cursors_[cursor].page_)->next_page_id_;
+      buffer_pool_manager_->UnpinPage(pageID, false);
+      buffer_pool_manager_->DeletePage(pageID);
+      DeleteRun(nextPageID);
+    }
+    for (page_id_t run : runs_) {
+      DeleteRun(run);
+    }
+  }
+
+  ExternalSorter(const ExternalSorter &) = delete;
+  ExternalSorter &operator=(const ExternalSorter &) = delete;
+
+  /**
+   * Add a record to sort. Must not be called once Sort was.
+   * @param record the record
+   */
+  void Add(const RecordType &record) {
+    buffer_.push_back(record);
+    if (buffer_.size() >= buffer_size_) {
+      SpillBuffer();
+    }
+  }
+
+  /** Sort the records added so far, they can then be read with Next. */
+  void Sort() {
+    if (runs_.empty()) {
+      std::sort(buffer_.begin(), buffer_.end(), less_);
+      return;
+    }
+    if (!buffer_.empty()) {
+      SpillBuffer();
+    }
+    std::vector<RecordType>().swap(buffer_);
+    // every run being merged pins a page, leave the other half of the pool to the caller
+    size_t fanIn = std::max<size_t>(buffer_pool_manager_->GetPoolSize() / 2, 2);
+    while (runs_.size() > fanIn) {
+      StartMerge(fanIn);
+      RunWriter writer;
+      RecordType record;
+      while (MergeNext(&record)) {
+        Append(&writer, record);
+      }
+      FinishRun(&writer);
+    }
+    StartMerge(runs_.size());
+  }
+
+  /**
+   * Read the next record in sorted order.
+   * @param[out] record the record
+   * @return false once all the records were read
+   */
+  bool Next(RecordType *record) {
+    if (!merging_) {
+      if (position_ == buffer_.size()) {
+        return false;
+      }
+      *record = buffer_[position_++];
+      return true;
+    }
+    return MergeNext(record);
+  }
+
+  /** @return the number of runs spilled so far, including the ones written by intermediate merges */
+  size_t GetNumSpilledRuns() const { return num_spilled_runs_; }
+
+ private:
+  /** Read position in a run being merged. */
+  struct RunCursor {
+    // pinned page of the run
+    Page *page_;
+    // next record of the page
+    int index_;
+  };
+
+  /** Run being written. */
+  struct RunWriter {
+    page_id_t first_page_id_{INVALID_PAGE_ID};
+    // pinned last page of the run
+    Page *page_{nullptr};
+  };
+
+  static RunPage *Records(Page *page) { return reinterpret_cast<RunPage *>(page->GetData()); }
+
+  const RecordType &Current(size_t cursor) const {
+    return Records(cursors_[cursor].page_)->records_[cursors_[cursor].index_];
+  }
+
+  void SpillBuffer() {
+    std::sort(buffer_.begin(), buffer_.end(), less_);
+    RunWriter writer;
+    for (const auto &record : buffer_) {
+      Append(&writer, record);
+    }
+    FinishRun(&writer);
+    buffer_.clear();
+  }
+
+  void Append(RunWriter *writer, const RecordType &record) {
+    if (writer->page_ == nullptr || Records(writer->page_)->size_ == RECORDS_PER_PAGE) {
+      page_id_t newPageID;
+      Page *newPage = buffer_pool_manager_->NewPage(&newPageID);
+      if (newPage == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+      }
+      Records(newPage)->next_page_id_ = INVALID_PAGE_ID;
+      Records(newPage)->size_ = 0;
+      if (writer->page_ == nullptr) {
+        writer->first_page_id_ = newPageID;
+      } else {
+        Records(writer->page_)->next_page_id_ = newPageID;
+        buffer_pool_manager_->UnpinPage(writer->page_->GetPageId(), true);
+      }
+      writer->page_ = newPage;
+    }
+    RunPage *run = Records(writer->page_);
+    run->records_[run->size_++] = record;
+  }
+
+  void FinishRun(RunWriter *writer) {
+    if (writer->page_ == nullptr) {
+      return;
+    }
+    buffer_pool_manager_->UnpinPage(writer->page_->GetPageId(), true);
+    runs_.push_back(writer->first_page_id_);
+    num_spilled_runs_++;
+  }
+
+  /** Pin the first page of the first num_runs runs and heap them up by their first record. */
+  void StartMerge(size_t num_runs) {
+    merging_ = true;
+    cursors_.clear();
+    heap_.clear();
+    for (size_t i = 0; i < num_runs; i++) {
+      Page *page = buffer_pool_manager_->FetchPage(runs_.front());
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+      }
+      runs_.pop_front();
+      cursors_.push_back(RunCursor{page, 0});
+      heap_.push_back(i);
+    }
+    std::make_heap(heap_.begin(), heap_.end(), HeapLess());
+  }
+
+  bool MergeNext(RecordType *record) {
+    if (heap_.empty()) {
+      return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), HeapLess());
+    size_t cursor = heap_.back();
+    *record = Current(cursor);
+    if (++cursors_[cursor].index_ < Records(cursors_[cursor].page_)->size_) {
+      std::push_heap(heap_.begin(), heap_.end(), HeapLess());
+      return true;
+    }
+    // the page is consumed, move on to the next one of the run
+    page_id_t pageID = cursors_[cursor].page_->GetPageId();
+    page_id_t nextPageID = Records(cursors_[cursor].page_)->next_page_id_;
+    buffer_pool_manager_->UnpinPage(pageID, false);
+    buffer_pool_manager_->DeletePage(pageID);
+    if (nextPageID == INVALID_PAGE_ID) {
+      heap_.pop_back();
+      return true;
+    }
+    Page *page = buffer_pool_manager_->FetchPage(nextPageID);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+    }
+    cursors_[cursor] = RunCursor{page, 0};
+    std::push_heap(heap_.begin(), heap_.end(), HeapLess());
+    return true;
+  }
+
+  /** Orders the heap so that the cursor with the smallest record is on top. */
+  auto HeapLess() const {
+    return [this](size_t a, size_t b) { return less_(Current(b), Current(a)); };
+  }
+
+  void DeleteRun(page_id_t page_id) {
+    while (page_id != INVALID_PAGE_ID) {
+      Page *page = buffer_pool_manager_->FetchPage(page_id);
+      if (page == nullptr) {
+        return;
+      }
+      page_id_t nextPageID = Records(page)->next_page_id_;
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      page_id = nextPageID;
+    }
+  }
+
+  BufferPoolManager *buffer_pool_manager_;
+  Less less_;
+  // records sorted in memory at once
+  size_t buffer_size_;
+  std::vector<RecordType> buffer_;
+  // next record of buffer_ to read when nothing was spilled
+  size_t position_{0};
+  // first page of every run not being merged yet
+  std::deque<page_id_t> runs_;
+  size_t num_spilled_runs_{0};
+  // true once the records are read from a merge of the runs
+  bool merging_{false};
+  std::vector<RunCursor> cursors_;
+  // indexes into cursors_ of the runs not consumed yet
+  std::vector<size_t> heap_;
+};
+
+}  // namespace bustub
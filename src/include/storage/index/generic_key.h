@@ -12,8 +12,14 @@
 
 #pragma once
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
 #include <cstring>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -35,6 +41,87 @@ class GenericKey {
     memcpy(data_, tuple.GetData(), tuple.GetLength());
   }
 
+  /**
+   * Encode the key so that memcmp orders encoded keys like the values of their columns, see KeyLayout::NORMALIZED.
+   * Integers are stored big-endian with the sign bit flipped, decimals with the sign bit flipped or every bit inverted
+   * if negative, and varchars behind a null marker, zero padded to the length of the column and followed by their
+   * length. The null of a fixed width type is its smallest or largest value, so it needs no marker.
+   */
+  inline void SetFromNormalizedKey(const Tuple &tuple, const Schema *key_schema) {
+    memset(data_, 0, KeySize);
+    char *data = data_;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      const Column &column = key_schema->GetColumn(i);
+      const Value value = tuple.GetValue(key_schema, i);
+      switch (column.GetType()) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+          data = EncodeSigned(data, value.GetAs<int8_t>(), sizeof(int8_t));
+          break;
+        case TypeId::SMALLINT:
+          data = EncodeSigned(data, value.GetAs<int16_t>(), sizeof(int16_t));
+          break;
+        case TypeId::INTEGER:
+          data = EncodeSigned(data, value.GetAs<int32_t>(), sizeof(int32_t));
+          break;
+        case TypeId::BIGINT:
+          data = EncodeSigned(data, value.GetAs<int64_t>(), sizeof(int64_t));
+          break;
+        case TypeId::TIMESTAMP:
+          data = EncodeBigEndian(data, value.GetAs<uint64_t>(), sizeof(uint64_t));
+          break;
+        case TypeId::DECIMAL: {
+          uint64_t bits;
+          double decimal = value.GetAs<double>();
+          memcpy(&bits, &decimal, sizeof(bits));
+          bits = (bits >> 63) != 0 ? ~bits : bits | (1ULL << 63);
+          data = EncodeBigEndian(data, bits, sizeof(uint64_t));
+          break;
+        }
+        case TypeId::VARCHAR: {
+          // the length of a varchar value counts its terminating '\0', longer values are cut to the column length
+          uint32_t length = 0;
+          *data++ = value.IsNull() ? 0 : 1;
+          if (!value.IsNull()) {
+            length = std::min(value.GetLength() - 1, column.GetLength());
+            memcpy(data, value.GetData(), length);
+          }
+          data = EncodeBigEndian(data + column.GetLength(), length, sizeof(uint32_t));
+          break;
+        }
+        default:
+          BUSTUB_ASSERT(false, "column type can not be normalized");
+      }
+    }
+  }
+
+  /** @return the size of the normalized keys of the key schema, 0 if a column type can not be normalized */
+  static size_t NormalizedSize(const Schema *key_schema) {
+    size_t size = 0;
+    for (const Column &column : key_schema->GetColumns()) {
+      switch (column.GetType()) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+        case TypeId::SMALLINT:
+        case TypeId::INTEGER:
+        case TypeId::BIGINT:
+        case TypeId::TIMESTAMP:
+        case TypeId::DECIMAL:
+          size += Type::GetTypeSize(column.GetType());
+          break;
+        case TypeId::VARCHAR:
+          if (column.GetLength() == 0) {
+            return 0;
+          }
+          size += 1 + column.GetLength() + sizeof(uint32_t);
+          break;
+        default:
+          return 0;
+      }
+    }
+    return size;
+  }
+
   // NOTE: for test purpose only
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
@@ -68,8 +155,28 @@ class GenericKey {
 
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  /** Writes the low size bytes of bits, most significant first, @return the end of the bytes written */
+  static inline char *EncodeBigEndian(char *data, uint64_t bits, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      data[i] = static_cast<char>(bits >> (8 * (size - 1 - i)));
+    }
+    return data + size;
+  }
+
+  static inline char *EncodeSigned(char *data, int64_t value, size_t size) {
+    return EncodeBigEndian(data, static_cast<uint64_t>(value) ^ (1ULL << (8 * size - 1)), size);
+  }
 };
 
+/**
+ * How GenericComparator reads a key, picked from the key schema when the comparator is created.
+ * A key with a single integer column is compared as that integer, without going through Value. Other keys whose
+ * normalized encoding fits are compared with memcmp, they must be set with GenericKey::SetFromNormalizedKey.
+ */
+enum class KeyLayout { GENERIC, TINYINT, SMALLINT, INTEGER, BIGINT, NORMALIZED };
+
 /**
  * Function object returns true if lhs < rhs, used for trees
  */
@@ -77,6 +184,21 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    switch (layout_) {
+      case KeyLayout::TINYINT:
+        return CompareInteger<int8_t>(lhs, rhs);
+      case KeyLayout::SMALLINT:
+        return CompareInteger<int16_t>(lhs, rhs);
+      case KeyLayout::INTEGER:
+        return CompareInteger<int32_t>(lhs, rhs);
+      case KeyLayout::BIGINT:
+        return CompareInteger<int64_t>(lhs, rhs);
+      case KeyLayout::NORMALIZED:
+        return memcmp(lhs.data_, rhs.data_, KeySize);
+      default:
+        break;
+    }
+
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +216,138 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_}, layout_{other.layout_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema), layout_(LayoutOf(key_schema)) {}
+
+  /** Creates a comparator that reads the keys with the given layout, GENERIC always works. */
+  GenericComparator(Schema *key_schema, KeyLayout layout) : key_schema_(key_schema), layout_(layout) {}
+
+  /** @return the fastest layout that orders keys of the key schema like the generic one */
+  static KeyLayout LayoutOf(const Schema *key_schema) {
+    // a single inlined column is serialized at the start of the key, null as the smallest value of its type
+    if (key_schema->GetColumnCount() == 1) {
+      switch (key_schema->GetColumn(0).GetType()) {
+        case TypeId::TINYINT:
+          return KeyLayout::TINYINT;
+        case TypeId::SMALLINT:
+          return KeyLayout::SMALLINT;
+        case TypeId::INTEGER:
+          return KeySize >= sizeof(int32_t) ? KeyLayout::INTEGER : KeyLayout::GENERIC;
+        case TypeId::BIGINT:
+          return KeySize >= sizeof(int64_t) ? KeyLayout::BIGINT : KeyLayout::GENERIC;
+        default:
+          break;
+      }
+    }
+    size_t normalized_size = GenericKey<KeySize>::NormalizedSize(key_schema);
+    return normalized_size != 0 && normalized_size <= KeySize ? KeyLayout::NORMALIZED : KeyLayout::GENERIC;
+  }
+
+  KeyLayout GetLayout() const { return layout_; }
+
+  /** @return the index of the first pair of the sorted array[begin, end) whose key is not less than key */
+  template <typename PairType>
+  int LowerBound(const PairType *array, int begin, int end, const GenericKey<KeySize> &key) const {
+    return Search(array, begin, end, key, false);
+  }
+
+  /** @return the index of the first pair of the sorted array[begin, end) whose key is greater than key */
+  template <typename PairType>
+  int UpperBound(const PairType *array, int begin, int end, const GenericKey<KeySize> &key) const {
+    return Search(array, begin, end, key, true);
+  }
 
  private:
+  // pairs left once the binary search of Search narrowed them down, counted without branching
+  static constexpr int SEARCH_WINDOW = 16;
+
+  /**
+   * Binary search down to SEARCH_WINDOW pairs, then count the keys of the window that are less than key, or not
+   * greater than it if or_equal. Keys of an integer layout are counted with AVX2 when the build targets it.
+   */
+  template <typename PairType>
+  int Search(const PairType *array, int begin, int end, const GenericKey<KeySize> &key, bool or_equal) const {
+    while (end - begin > SEARCH_WINDOW) {
+      int mid = begin + (end - begin) / 2;
+      int cmp = (*this)(array[mid].first, key);
+      if (cmp < 0 || (or_equal && cmp == 0)) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    const char *keys = reinterpret_cast<const char *>(&array[begin].first);
+    switch (layout_) {
+      case KeyLayout::INTEGER:
+        return begin + CountInteger<int32_t>(keys, sizeof(PairType), end - begin, key, or_equal);
+      case KeyLayout::BIGINT:
+        return begin + CountInteger<int64_t>(keys, sizeof(PairType), end - begin, key, or_equal);
+      default:
+        break;
+    }
+    while (begin < end) {
+      int cmp = (*this)(array[begin].first, key);
+      if (cmp > 0 || (!or_equal && cmp == 0)) {
+        break;
+      }
+      begin++;
+    }
+    return begin;
+  }
+
+  /** @return how many of the n integer keys stride bytes apart are less than key, or not greater if or_equal */
+  template <typename T>
+  static inline int CountInteger(const char *keys, size_t stride, int n, const GenericKey<KeySize> &key,
+                                 bool or_equal) {
+    T needle;
+    memcpy(&needle, key.data_, sizeof(T));
+    int count = 0;
+    int i = 0;
+#ifdef __AVX2__
+    // compare lanes of keys gathered from the pairs, keys <= needle are counted as the lanes not greater than it
+    const auto s = static_cast<int>(stride);
+    if constexpr (sizeof(T) == sizeof(int64_t)) {
+      const __m128i offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+      const __m256i needles = _mm256_set1_epi64x(needle);
+      for (; i + 4 <= n; i += 4) {
+        __m256i lanes = _mm256_i32gather_epi64(reinterpret_cast<const long long *>(keys + i * stride),  // NOLINT
+                                               offsets, 1);
+        __m256i mask = or_equal ? _mm256_cmpgt_epi64(lanes, needles) : _mm256_cmpgt_epi64(needles, lanes);
+        int bits = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+        count += or_equal ? 4 - bits : bits;
+      }
+    } else {
+      const __m256i offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+      const __m256i needles = _mm256_set1_epi32(needle);
+      for (; i + 8 <= n; i += 8) {
+        __m256i lanes = _mm256_i32gather_epi32(reinterpret_cast<const int *>(keys + i * stride), offsets, 1);
+        __m256i mask = or_equal ? _mm256_cmpgt_epi32(lanes, needles) : _mm256_cmpgt_epi32(needles, lanes);
+        int bits = __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+        count += or_equal ? 8 - bits : bits;
+      }
+    }
+#endif
+    for (; i < n; i++) {
+      T value;
+      memcpy(&value, keys + i * stride, sizeof(T));
+      count += static_cast<int>(or_equal ? value <= needle : value < needle);
+    }
+    return count;
+  }
+
+  template <typename T>
+  static inline int CompareInteger(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) {
+    T lhs_value;
+    T rhs_value;
+    memcpy(&lhs_value, lhs.data_, sizeof(T));
+    memcpy(&rhs_value, rhs.data_, sizeof(T));
+    return (lhs_value > rhs_value) - (lhs_value < rhs_value);
+  }
+
   Schema *key_schema_;
+  KeyLayout layout_;
 };
 
 }  // namespace bustub
@@ -13,23 +13,63 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <functional>
 #include <list>
+#include <vector>
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * IndexIterator walks the pairs of the leaves in key order, optionally up to an end key.
+ *
+ * The iterator holds no latch and no pin between calls. When it gets to a leaf, it copies the pairs of the leaf it is
+ * going to visit under the leaf read latch and releases the leaf, so the thread holding the iterator may modify the
+ * tree, e.g. delete the tuples it visits through the same index. Once the copied pairs are visited, the leaf after the
+ * last key copied is found again from the root, since the next leaf the copy pointed to may have been merged away.
+ *
+ * Walking over empty leaves latches the next leaf before the current one is released. Writers that merge or
+ * redistribute latch the left sibling while holding the right one, so the next leaf is only try-latched: if that
+ * fails, the iterator lets go of its leaf and finds the key after the last one of the leaf from the root instead of
+ * waiting, which could deadlock.
+ *
+ * A key with a posting list is visited once per value, the values are copied with the pairs of the leaf.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = B_PLUS_TREE_LEAF_PAGE_TYPE;
+
  public:
-  // you may define your own constructor based on your member variables
+  /** Finds the leaf page that should contain a key, pinned and read latched, nullptr if the tree is empty. */
+  using LeafFinder = std::function<Page *(const KeyType &key)>;
+
+  /** Creates an iterator past the end. */
   IndexIterator();
-  IndexIterator(BufferPoolManager *bpm, page_id_t page_id, int index);
+  /**
+   * Creates an iterator at a pair of a leaf, or past it to the next pair that exists.
+   * @param bpm buffer pool manager of the tree
+   * @param page the leaf page, pinned and read latched, the iterator releases it
+   * @param index index of the first pair to visit in the leaf, may be its size
+   * @param end_key the last key to visit, nullptr to visit every key up to the right most one
+   * @param comparator comparator of the tree, must outlive the iterator
+   * @param find_leaf finds the leaf of a key from the root, to go on after the pairs copied from a leaf
+   * @param unique false if the values of the tree may be posting lists
+   */
+  IndexIterator(BufferPoolManager *bpm, Page *page, int index, const KeyType *end_key, const KeyComparator *comparator,
+                LeafFinder find_leaf, bool unique = true);
   ~IndexIterator();
 
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
+  IndexIterator(const IndexIterator &) = delete;
+  IndexIterator &operator=(const IndexIterator &) = delete;
+
   bool isEnd();
 
+  /** @return the current pair, valid until the iterator moves */
   const MappingType &operator*();
 
   IndexIterator &operator++();
@@ -41,10 +81,39 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const { return !((*this) == itr); }
 
  private:
-  // add your own private member variables here
-  BufferPoolManager *bpm_;
-  page_id_t page_id_;
-  int index_;
+  /**
+   * Copies the pairs to visit of a leaf, or of the first leaf after it that has some, and releases the leaf.
+   * @param page the leaf page, pinned and read latched, nullptr to end the iteration
+   * @param index index of the first pair to copy in the leaf, may be its size
+   */
+  void Load(Page *page, int index);
+  /**
+   * Finds the leaf of the first key after a key from the root.
+   * @param[out] index index of the first key after the key in the leaf
+   * @return the leaf page, pinned and read latched, nullptr if the tree is empty
+   */
+  Page *FindAfter(const KeyType &key, int *index);
+  /** Unlatches and unpins a leaf page. */
+  void Unlatch(Page *page);
+  /** Moves the iterator past the end. */
+  void End();
+
+  BufferPoolManager *bpm_{nullptr};
+  // leaf the current pairs were copied from, INVALID_PAGE_ID past the end
+  page_id_t page_id_{INVALID_PAGE_ID};
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  // index of the current pair in items_
+  int index_{0};
+  bool has_end_key_{false};
+  KeyType end_key_;
+  const KeyComparator *comparator_{nullptr};
+  LeafFinder find_leaf_;
+  // end of the leaves read ahead so far, see BufferPoolManager::ReadAhead
+  page_id_t read_ahead_end_{INVALID_PAGE_ID};
+  bool unique_{true};
+  // the pairs copied from the leaf, with one pair per value of a posting list, and true if no pair comes after them
+  std::vector<MappingType> items_;
+  bool last_items_{true};
 };
 
 }  // namespace bustub
@@ -24,7 +24,8 @@ namespace bustub {
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Keys are unique within the leaves, the record ids of a duplicate key
+ * live in a posting list (see b_plus_tree_posting_page.h).
  *
  * Leaf page format (keys are stored in order):
  *  ----------------------------------------------------------------------
@@ -51,6 +52,7 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   KeyType KeyAt(int index) const;
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
   const MappingType &GetItem(int index);
+  void SetValueAt(int index, const ValueType &value);
 
   // insert and delete methods
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_posting_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+#define POSTING_PAGE_HEADER_SIZE 16
+#define POSTING_PAGE_SIZE ((PAGE_SIZE - POSTING_PAGE_HEADER_SIZE) / sizeof(RID))
+
+/**
+ * Store the record ids of a key that has more than one, in a B+ tree that
+ * allows duplicate keys. The leaf keeps the key once, with a marker record id
+ * that points at the first page of a chain of posting pages instead of a
+ * record. The structure of the tree only ever sees unique keys.
+ *
+ * A posting list is only read and written under the latch of the leaf that
+ * holds its key, so posting pages are not latched themselves.
+ *
+ * Posting page format (record ids are in no particular order):
+ *  ----------------------------------------------------------------------
+ * | HEADER | RID(1) | RID(2) | ... | RID(n)
+ *  ----------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 16 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | NextPageId (4) | CurrentSize (4) |
+ *  ---------------------------------------------------------------------
+ */
+class BPlusTreePostingPage {
+ public:
+  /** Slot number of a marker record id, table pages never have that many slots. */
+  static constexpr uint32_t POSTING_LIST_SLOT = UINT32_MAX;
+
+  /** @return true if the record id is a marker for a posting list rather than a record */
+  static bool IsPostingList(const RID &rid) {
+    return rid.GetSlotNum() == POSTING_LIST_SLOT && rid.GetPageId() != INVALID_PAGE_ID;
+  }
+
+  /** @return the marker record id for the posting list that starts at a page */
+  static RID PostingList(page_id_t page_id) { return RID(page_id, POSTING_LIST_SLOT); }
+
+  /**
+   * Append the record ids of a posting list.
+   * @param bpm buffer pool manager of the tree
+   * @param page_id the first page of the posting list
+   * @param[out] result receives the record ids
+   */
+  static void GetRIDs(BufferPoolManager *bpm, page_id_t page_id, std::vector<RID> *result);
+
+  // After creating a new posting page from buffer pool, must call initialize
+  // method to set default values
+  void Init(page_id_t page_id);
+
+  page_id_t GetPageId() const;
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+  int GetSize() const;
+  bool IsFull() const;
+  RID RIDAt(int index) const;
+
+  /** @return the index of the record id in this page, -1 if it is not here */
+  int Find(const RID &rid) const;
+  /** Append a record id, the page must not be full. */
+  void Append(const RID &rid);
+  /** Remove the record id at an index, the last one takes its place. */
+  void RemoveAt(int index);
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_ __attribute__((__unused__));
+  page_id_t next_page_id_;
+  int size_;
+  RID array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Store indexed key and value together within a bucket page of an extendible
+ * hash table. Supports non-unique keys, but not duplicate pairs.
+ *
+ * A bucket that can not be split any further, because all of its keys share
+ * the hash bits the directory can use, grows a chain of overflow pages. The
+ * page the directory points to is the head of the chain, and its latch guards
+ * the whole chain.
+ *
+ * Bucket page format (pairs are in no particular order):
+ *  ------------------------------------------------------------------------------------
+ * | Size (4) | NextPageId (4) | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ------------------------------------------------------------------------------------
+ *
+ *  Here '+' means concatenation.
+ *
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /** Empties a new bucket page, it ends its chain. */
+  void Init();
+
+  /** @return the page id of the next page of the chain, INVALID_PAGE_ID for its last page */
+  page_id_t GetNextPageId() const;
+
+  void SetNextPageId(page_id_t next_page_id);
+
+  /** @return true if the bucket holds the pair */
+  bool Contains(const KeyType &key, const ValueType &value, KeyComparator cmp) const;
+
+  /**
+   * Appends the values of a key.
+   * @param[out] result receives the values
+   * @return true if the key has at least one value
+   */
+  bool GetValue(const KeyType &key, KeyComparator cmp, std::vector<ValueType> *result) const;
+
+  /**
+   * Inserts a key and value.
+   * @return false if the bucket is full or already holds the pair
+   */
+  bool Insert(const KeyType &key, const ValueType &value, KeyComparator cmp);
+
+  /**
+   * Removes a key and value.
+   * @return false if the pair is not in the bucket
+   */
+  bool Remove(const KeyType &key, const ValueType &value, KeyComparator cmp);
+
+  KeyType KeyAt(uint32_t bucket_idx) const;
+
+  ValueType ValueAt(uint32_t bucket_idx) const;
+
+  /** Removes the pair at an index, the last pair takes its place. */
+  void RemoveAt(uint32_t bucket_idx);
+
+  /** @return the number of pairs in the bucket */
+  uint32_t GetSize() const;
+
+  bool IsFull() const;
+
+  bool IsEmpty() const;
+
+ private:
+  uint32_t size_;
+  page_id_t next_page_id_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
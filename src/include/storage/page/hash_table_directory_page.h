@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <string>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * The directory of an extendible hash table can double up to DIRECTORY_MAX_DEPTH, which fills its page. Buckets of
+ * that local depth grow overflow pages instead of splitting.
+ */
+#define DIRECTORY_MAX_DEPTH 9
+#define DIRECTORY_ARRAY_SIZE (1 << DIRECTORY_MAX_DEPTH)
+
+/**
+ *
+ * Directory Page for extendible hash table.
+ *
+ * Directory slot i points to the bucket of the keys whose hash ends with the
+ * global depth low bits of i. A bucket of local depth d is pointed to by every
+ * slot that ends with the same d low bits.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048) | Free
+ * --------------------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  /**
+   * Sets up an empty directory of global depth 0, its only slot has to be given a bucket.
+   * @param page_id the page id of this page
+   */
+  void Init(page_id_t page_id);
+
+  /** @return the page ID of this page */
+  page_id_t GetPageId() const;
+
+  /** @return the number of low bits of a hash used to find its slot */
+  uint32_t GetGlobalDepth() const;
+
+  /** @return a mask of the global depth low bits */
+  uint32_t GetGlobalDepthMask() const;
+
+  /** @return the number of slots of the directory */
+  uint32_t Size() const;
+
+  /** Doubles the directory, the new upper half points to the same buckets as the lower half. */
+  void IncrGlobalDepth();
+
+  /** Halves the directory, only if CanShrink. */
+  void DecrGlobalDepth();
+
+  /** @return true if every bucket has a local depth below the global depth, so the upper half mirrors the lower */
+  bool CanShrink() const;
+
+  /** @return the page id of the bucket of a slot */
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  /** @return the local depth of the bucket of a slot */
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth);
+
+  /**
+   * Asserts that every bucket has a local depth of at most the global depth, and is pointed to by exactly the
+   * 2^(global depth - local depth) slots that share its low bits.
+   */
+  void VerifyIntegrity() const;
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_ __attribute__((__unused__));
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -22,3 +22,9 @@
 #define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a bucket page of the extendible hash
+ * table, after the 4 bytes of its size and the 4 bytes of its next page id. */
+#define BUCKET_ARRAY_SIZE ((PAGE_SIZE - 8) / sizeof(MappingType))
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
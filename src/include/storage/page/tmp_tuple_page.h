@@ -1,15 +1,14 @@
 #pragma once
 
+#include <cstring>
+
+#include "common/macros.h"
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
  * TmpTuplePage format:
  *
@@ -17,17 +16,65 @@ namespace bustub {
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ * FreeSpace is the offset where the free space ends, tuples are added in front of it, from the end of the page.
+ * Operators that run out of memory spill their tuples to these pages, and read them back from their TmpTuples.
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  /** Initializes an empty page of page_size bytes. */
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData() + OFFSET_PAGE_ID, &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  /** @return the page id of this page */
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PAGE_ID); }
+
+  /**
+   * Copies a tuple into the page.
+   * @param tuple the tuple to insert
+   * @param[out] out where the tuple is on this page
+   * @return false if the page does not have room for the tuple
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    BUSTUB_ASSERT(tuple.GetLength() > 0, "Cannot have empty tuples.");
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    if (GetFreeSpacePointer() < SIZE_TMP_PAGE_HEADER + size) {
+      return false;
+    }
+    uint32_t offset = GetFreeSpacePointer() - size;
+    tuple.SerializeTo(GetData() + offset);
+    SetFreeSpacePointer(offset);
+    *out = TmpTuple(GetTablePageId(), offset);
+    return true;
+  }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /** Reads the tuple at a TmpTuple of this page into tuple. */
+  void Get(const TmpTuple &tmp_tuple, Tuple *tuple) {
+    BUSTUB_ASSERT(tmp_tuple.GetPageId() == GetTablePageId(), "The tuple is on another page.");
+    tuple->DeserializeFrom(GetData() + tmp_tuple.GetOffset());
+  }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /** @return the offset of the tuple inserted last, or the page size if the page is empty */
+  uint32_t GetFirstOffset() { return GetFreeSpacePointer(); }
+
+  /** @return the offset of the tuple inserted before the one at offset, or the page size if there is none */
+  uint32_t GetNextOffset(uint32_t offset) {
+    return offset + sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset);
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t SIZE_TMP_PAGE_HEADER = 12;
+  static constexpr size_t OFFSET_PAGE_ID = 0;
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
@@ -99,7 +99,11 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
-  /** @return the begin iterator of this table */
+  /**
+   * The iterator reads the table through a private ring of SCAN_RING_SIZE buffer pool frames, so that scanning a large
+   * table does not evict the rest of the buffer pool.
+   * @return the begin iterator of this table
+   */
   TableIterator Begin(Transaction *txn);
 
   /** @return the end iterator of this table */
@@ -13,10 +13,13 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 
@@ -29,10 +32,21 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  /**
+   * @param table_heap the table heap to iterate
+   * @param rid the rid of the first tuple
+   * @param txn the transaction performing the scan
+   * @param strategy the buffer access strategy of the scan, nullptr to fetch pages as usual
+   */
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn,
+                std::shared_ptr<BufferAccessStrategy> strategy = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        strategy_(other.strategy_),
+        read_ahead_end_(other.read_ahead_end_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -48,10 +62,19 @@ class TableIterator {
 
   TableIterator operator++(int);
 
+  /**
+   * Reads the tuples from the current one to the end of its page into a batch, as many as fit, under a single fetch
+   * and latch of the page, then moves on to the tuple after the last one read.
+   * @param batch the batch the tuples are appended to, in place in its free slots
+   */
+  void ReadBatch(TupleBatch *batch);
+
   TableIterator &operator=(const TableIterator &other) {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    strategy_ = other.strategy_;
+    read_ahead_end_ = other.read_ahead_end_;
     return *this;
   }
 
@@ -59,6 +82,10 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** Shared by the copies of the iterator, since they walk the same scan. */
+  std::shared_ptr<BufferAccessStrategy> strategy_;
+  /** End of the pages read ahead of the scan so far, see BufferPoolManager::ReadAhead. */
+  page_id_t read_ahead_end_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/storage/table/tuple_batch.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch is a fixed capacity array of tuples and their RIDs, that executors fill in NextBatch.
+ * Its slots are allocated once and reused by every batch, and tuples are moved in and out of them.
+ */
+class TupleBatch {
+ public:
+  /** Creates an empty batch of at most capacity tuples. */
+  explicit TupleBatch(uint32_t capacity = EXECUTION_BATCH_SIZE)
+      : capacity_(capacity), tuples_(capacity), rids_(capacity) {}
+
+  /** Empties the batch, keeping its slots. */
+  void Clear() { size_ = 0; }
+
+  /** Appends a tuple and its RID to the batch, which must not be full. */
+  void Append(Tuple &&tuple, const RID &rid) {
+    assert(size_ < capacity_);
+    tuples_[size_] = std::move(tuple);
+    rids_[size_] = rid;
+    size_++;
+  }
+
+  /**
+   * @return the slot the next tuple is appended in, to be filled in place, e.g. by TablePage::GetTuple, which reuses
+   * the storage of the tuple the slot held in a previous batch
+   */
+  Tuple *FreeSlot() {
+    assert(size_ < capacity_);
+    return &tuples_[size_];
+  }
+
+  /** Appends the tuple filled in the free slot, and its RID. */
+  void AppendSlot(const RID &rid) {
+    assert(size_ < capacity_);
+    rids_[size_] = rid;
+    size_++;
+  }
+
+  /** Keeps only the tuples [begin, end) of the batch, moved to its front. */
+  void Slice(uint32_t begin, uint32_t end) {
+    assert(begin <= end && end <= size_);
+    if (begin != 0) {
+      for (uint32_t i = begin; i < end; i++) {
+        tuples_[i - begin] = std::move(tuples_[i]);
+        rids_[i - begin] = rids_[i];
+      }
+    }
+    size_ = end - begin;
+  }
+
+  /** @return the tuple at index i */
+  Tuple &TupleAt(uint32_t i) {
+    assert(i < size_);
+    return tuples_[i];
+  }
+
+  /** @return the RID of the tuple at index i */
+  const RID &RIDAt(uint32_t i) const {
+    assert(i < size_);
+    return rids_[i];
+  }
+
+  /** @return the number of tuples in the batch */
+  uint32_t Size() const { return size_; }
+
+  /** @return the most tuples the batch holds */
+  uint32_t Capacity() const { return capacity_; }
+
+  bool IsEmpty() const { return size_ == 0; }
+
+  bool IsFull() const { return size_ == capacity_; }
+
+ private:
+  uint32_t capacity_;
+  uint32_t size_{0};
+  std::vector<Tuple> tuples_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
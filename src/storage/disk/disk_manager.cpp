@@ -10,8 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -29,8 +36,18 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, DiskIOBackend backend, bool direct_io)
+    : db_fd_(-1),
+      backend_(backend),
+      direct_io_(direct_io),
+      direct_io_alignment_(DIRECT_IO_ALIGNMENT),
+      file_name_(db_file),
+      next_page_id_(0),
+      num_flushes_(0),
+      num_writes_(0),
+      num_reads_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -52,19 +69,39 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
 
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  // positional I/O on the db file, pread/pwrite never move a shared file cursor
+#ifdef O_DIRECT
+  if (direct_io_) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("O_DIRECT is not supported by the file system, falling back to buffered I/O");
     }
   }
+#endif
+#ifdef STATX_DIOALIGN
+  // Some devices need a larger alignment than most, ask the kernel when it knows.
+  struct statx stx;
+  if (db_fd_ >= 0 && statx(db_fd_, "", AT_EMPTY_PATH, STATX_DIOALIGN, &stx) == 0 &&
+      (stx.stx_mask & STATX_DIOALIGN) != 0 && stx.stx_dio_mem_align > 0) {
+    direct_io_alignment_ = std::max<size_t>(stx.stx_dio_mem_align, stx.stx_dio_offset_align);
+  }
+#endif
+  if (db_fd_ < 0) {
+    direct_io_ = false;
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  if (backend_ == DiskIOBackend::IO_URING) {
+    io_uring_ = std::make_unique<IoUring>(IO_URING_QUEUE_DEPTH);
+    if (!io_uring_->IsValid()) {
+      LOG_WARN("io_uring is not available, falling back to pread");
+      io_uring_ = nullptr;
+      backend_ = DiskIOBackend::PREAD;
+    }
+  }
+  LoadFreeSpaceMap();
   buffer_used = nullptr;
 }
 
@@ -72,54 +109,120 @@ DiskManager::DiskManager(const std::string &db_file)
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  db_io_.close();
+  if (db_fd_ >= 0) {
+    FlushFreeSpaceMap();
+    close(db_fd_);
+    db_fd_ = -1;
+  }
   log_io_.close();
 }
 
+DiskManager::~DiskManager() {
+  if (db_fd_ >= 0) {
+    FlushFreeSpaceMap();
+    close(db_fd_);
+  }
+}
+
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
+  off_t offset = PageOffset(page_id);
+  alignas(PAGE_SIZE) char bounce[PAGE_SIZE];
+  if (!IsAligned(page_data)) {
+    memcpy(bounce, page_data, PAGE_SIZE);
+    page_data = bounce;
+  }
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
+  // pwrite hands the data straight to the OS, there is no user space buffer left to flush
+  if (pwrite(db_fd_, page_data, PAGE_SIZE, offset) != PAGE_SIZE) {
     LOG_DEBUG("I/O error while writing");
-    return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
+void DiskManager::ReadPage(page_id_t page_id, char *page_data) { ReadPageChecked(page_id, page_data); }
+
+bool DiskManager::ReadPageChecked(page_id_t page_id, char *page_data) {
+  if (!IsAligned(page_data)) {
+    alignas(PAGE_SIZE) char bounce[PAGE_SIZE];
+    if (!ReadPageChecked(page_id, bounce)) {
+      return false;
+    }
+    memcpy(page_data, bounce, PAGE_SIZE);
+    return true;
+  }
+  off_t offset = PageOffset(page_id);
+  num_reads_ += 1;
+  ssize_t read_count = pread(db_fd_, page_data, PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading");
+    return false;
+  }
+  // if file ends before reading PAGE_SIZE, e.g. the page was allocated but never written
+  if (read_count < PAGE_SIZE) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+  }
+  return true;
+}
+
+/**
+ * Read the contents of several pages, one vectored I/O per run of consecutive page ids
+ * A run stops at the end of a block group, the map page of the next group sits in between
+ */
+std::vector<bool> DiskManager::ReadPages(const std::vector<page_id_t> &page_ids,
+                                         const std::vector<char *> &page_data) {
+  assert(page_ids.size() == page_data.size());
+  std::vector<bool> read(page_ids.size(), true);
+  if (!std::all_of(page_data.begin(), page_data.end(), [this](const char *data) { return IsAligned(data); })) {
+    for (size_t i = 0; i < page_ids.size(); ++i) {
+      read[i] = ReadPageChecked(page_ids[i], page_data[i]);
+    }
+    return read;
+  }
+  std::vector<struct iovec> iovs(page_ids.size());
+  std::vector<IoUring::Request> requests;
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    iovs[i].iov_base = page_data[i];
+    iovs[i].iov_len = PAGE_SIZE;
+    if (i > 0 && page_ids[i] == page_ids[i - 1] + 1 && page_ids[i] % PAGES_PER_MAP != 0 &&
+        requests.back().iov_count_ < IOV_MAX) {
+      requests.back().iov_count_++;
+    } else {
+      requests.push_back({&iovs[i], 1, PageOffset(page_ids[i]), 0});
+    }
+  }
+  num_reads_ += static_cast<int>(requests.size());
+
+  if (io_uring_ != nullptr) {
+    std::lock_guard<std::mutex> guard(io_uring_latch_);
+    io_uring_->SubmitAndWait(db_fd_, false, &requests);
   } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
+    for (auto &request : requests) {
+      request.result_ = preadv(db_fd_, request.iov_, request.iov_count_, request.offset_);
+    }
+  }
+
+  // pages past the end of the file have not been written yet, read them as zeros
+  for (auto &request : requests) {
+    size_t first = request.iov_ - iovs.data();
+    if (request.result_ < 0) {
       LOG_DEBUG("I/O error while reading");
-      return;
+      std::fill(read.begin() + first, read.begin() + first + request.iov_count_, false);
+      continue;
     }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+    int64_t read_count = request.result_;
+    for (int i = 0; i < request.iov_count_; ++i) {
+      int64_t page_read = std::min<int64_t>(std::max<int64_t>(read_count, 0), PAGE_SIZE);
+      memset(static_cast<char *>(request.iov_[i].iov_base) + page_read, 0, PAGE_SIZE - page_read);
+      read_count -= PAGE_SIZE;
     }
   }
+  return read;
 }
 
 /**
@@ -186,16 +289,141 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
 
 /**
  * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * First fit in the free-space maps, the file only grows when no freed page is left
+ */
+page_id_t DiskManager::AllocatePage() { return AllocateExtent(1); }
+
+/**
+ * Allocate a run of consecutive pages (operations like bulk loading an index)
+ */
+page_id_t DiskManager::AllocateExtent(int num_pages) {
+  if (num_pages <= 0 || num_pages > PAGES_PER_MAP) {
+    return INVALID_PAGE_ID;
+  }
+  std::lock_guard<std::mutex> guard(allocation_latch_);
+  page_id_t page_id = FindFreeExtent(num_pages);
+  SetAllocated(page_id, num_pages, true);
+  if (page_id == first_free_hint_) {
+    first_free_hint_ += num_pages;
+  }
+  if (page_id + num_pages > next_page_id_) {
+    next_page_id_ = page_id + num_pages;
+  }
+  return page_id;
+}
+
+/**
+ * Deallocate page (operations like drop index/table, or pages freed by a B+ tree merge)
+ * The page is cleared in its free-space map and handed out again by a later allocation
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(allocation_latch_);
+  if (page_id < 0 || !IsAllocatedLocked(page_id)) {
+    return;
+  }
+  SetAllocated(page_id, 1, false);
+  first_free_hint_ = std::min(first_free_hint_, page_id);
+}
+
+bool DiskManager::IsAllocated(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(allocation_latch_);
+  return page_id >= 0 && IsAllocatedLocked(page_id);
+}
+
+bool DiskManager::IsAllocatedLocked(page_id_t page_id) const {
+  auto group = static_cast<size_t>(page_id / PAGES_PER_MAP);
+  if (group >= free_space_maps_.size()) {
+    return false;
+  }
+  page_id_t bit = page_id % PAGES_PER_MAP;
+  return (free_space_maps_[group][bit / 8] & (1 << (bit % 8))) != 0;
+}
+
+page_id_t DiskManager::FindFreeExtent(int num_pages) {
+  // Every page from next_page_id_ on is free, so this always finds a run.
+  page_id_t start = first_free_hint_;
+  while (true) {
+    if (start % PAGES_PER_MAP + num_pages > PAGES_PER_MAP) {
+      start = (start / PAGES_PER_MAP + 1) * PAGES_PER_MAP;
+      continue;
+    }
+    int length = 0;
+    while (length < num_pages && !IsAllocatedLocked(start + length)) {
+      ++length;
+    }
+    if (length == num_pages) {
+      return start;
+    }
+    start += length + 1;
+  }
+}
+
+void DiskManager::SetAllocated(page_id_t page_id, int num_pages, bool allocated) {
+  auto group = static_cast<size_t>(page_id / PAGES_PER_MAP);
+  if (group >= free_space_maps_.size()) {
+    free_space_maps_.resize(group + 1, std::vector<char>(PAGE_SIZE, 0));
+    dirty_maps_.resize(group + 1, false);
+  }
+  std::vector<char> &map = free_space_maps_[group];
+  for (page_id_t bit = page_id % PAGES_PER_MAP; bit < page_id % PAGES_PER_MAP + num_pages; ++bit) {
+    if (allocated) {
+      map[bit / 8] = static_cast<char>(map[bit / 8] | (1 << (bit % 8)));
+    } else {
+      map[bit / 8] = static_cast<char>(map[bit / 8] & ~(1 << (bit % 8)));
+    }
+  }
+  dirty_maps_[group] = true;
+}
 
 /**
- * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * Write the map pages changed since the last flush
+ * Map writes are bookkeeping, not counted as page writes
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+bool DiskManager::FlushFreeSpaceMap() {
+  std::lock_guard<std::mutex> guard(allocation_latch_);
+  bool flushed = true;
+  alignas(PAGE_SIZE) char data[PAGE_SIZE];
+  for (size_t group = 0; group < free_space_maps_.size(); ++group) {
+    if (!dirty_maps_[group]) {
+      continue;
+    }
+    memcpy(data, free_space_maps_[group].data(), PAGE_SIZE);
+    if (pwrite(db_fd_, data, PAGE_SIZE, MapOffset(group)) != PAGE_SIZE) {
+      // the map page stays dirty, the next flush tries again
+      LOG_WARN("I/O error while writing the free-space map of group %zu", group);
+      flushed = false;
+      continue;
+    }
+    dirty_maps_[group] = false;
+  }
+  return flushed;
+}
+
+void DiskManager::LoadFreeSpaceMap() {
+  struct stat stat_buf;
+  if (fstat(db_fd_, &stat_buf) != 0) {
+    return;
+  }
+  off_t group_size = static_cast<off_t>(PAGES_PER_MAP + 1) * PAGE_SIZE;
+  auto num_groups = static_cast<size_t>((stat_buf.st_size + group_size - 1) / group_size);
+  free_space_maps_.assign(num_groups, std::vector<char>(PAGE_SIZE, 0));
+  dirty_maps_.assign(num_groups, false);
+  alignas(PAGE_SIZE) char data[PAGE_SIZE];
+  for (size_t group = 0; group < num_groups; ++group) {
+    ssize_t read_count = pread(db_fd_, data, PAGE_SIZE, MapOffset(group));
+    if (read_count > 0) {
+      memcpy(free_space_maps_[group].data(), data, read_count);
+    }
+  }
+  // The page ids handed out before the restart are above every allocated page.
+  for (page_id_t page_id = static_cast<page_id_t>(num_groups) * PAGES_PER_MAP - 1; page_id >= 0; --page_id) {
+    if (IsAllocatedLocked(page_id)) {
+      next_page_id_ = page_id + 1;
+      break;
+    }
+  }
+  first_free_hint_ = 0;
+}
 
 /**
  * Returns number of flushes made so far
@@ -207,6 +435,16 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of pages allocated so far
+ */
+page_id_t DiskManager::GetNumPages() const { return next_page_id_; }
+
+/**
+ * Returns number of reads made so far
+ */
+int DiskManager::GetNumReads() const { return num_reads_; }
+
 /**
  * Returns true if the log is currently being flushed
  */
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_uring.cpp
+//
+// Identification: src/storage/disk/io_uring.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/io_uring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define BUSTUB_HAS_IO_URING
+#endif
+
+namespace bustub {
+
+#ifdef BUSTUB_HAS_IO_URING
+
+IoUring::IoUring(unsigned entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_fd_ < 0) {
+    return;
+  }
+  sq_entries_ = params.sq_entries;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  // Recent kernels map both rings with a single mmap.
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  cq_ring_ = single_mmap ? sq_ring_
+                         : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+    sqes_ = sqes == MAP_FAILED ? nullptr : static_cast<struct io_uring_sqe *>(sqes);
+    Unmap();
+    close(ring_fd_);
+    ring_fd_ = -1;
+    return;
+  }
+  sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+  if (ring_fd_ >= 0) {
+    Unmap();
+    close(ring_fd_);
+  }
+}
+
+void IoUring::Unmap() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != MAP_FAILED && sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+}
+
+void IoUring::SubmitAndWait(int fd, bool write, std::vector<Request> *requests) {
+  size_t next = 0;
+  while (next < requests->size()) {
+    // Fill the submission queue. We are the only producer, so the tail can be read without synchronization.
+    auto batch = static_cast<unsigned>(std::min<size_t>(sq_entries_, requests->size() - next));
+    unsigned tail = *sq_tail_;
+    for (unsigned i = 0; i < batch; ++i) {
+      Request &request = (*requests)[next + i];
+      unsigned index = tail & *sq_mask_;
+      struct io_uring_sqe *sqe = &sqes_[index];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+      sqe->fd = fd;
+      sqe->addr = reinterpret_cast<uint64_t>(request.iov_);
+      sqe->len = static_cast<uint32_t>(request.iov_count_);
+      sqe->off = static_cast<uint64_t>(request.offset_);
+      sqe->user_data = next + i;
+      sq_array_[index] = index;
+      ++tail;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+    // Submit the whole batch and wait for all of it with one system call.
+    unsigned submitted = 0;
+    while (submitted < batch) {
+      auto ret = syscall(__NR_io_uring_enter, ring_fd_, batch - submitted, batch - submitted,
+                         IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (ret < 0) {
+        int error = errno;
+        if (error == EINTR) {
+          continue;
+        }
+        // Take back the entries the kernel did not consume, their buffers do not outlive this call. The kernel only
+        // moves the head while we are in io_uring_enter, so the head is stable here.
+        __atomic_store_n(sq_tail_, __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        for (unsigned i = submitted; i < batch; ++i) {
+          (*requests)[next + i].result_ = -error;
+        }
+        break;
+      }
+      submitted += static_cast<unsigned>(ret);
+    }
+
+    // Reap the completions from the shared completion queue.
+    unsigned completed = 0;
+    while (completed < submitted) {
+      unsigned head = *cq_head_;
+      unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      if (head == cq_tail) {
+        syscall(__NR_io_uring_enter, ring_fd_, 0, submitted - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+        continue;
+      }
+      for (; head != cq_tail; ++head, ++completed) {
+        struct io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+        (*requests)[cqe->user_data].result_ = cqe->res;
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+    next += batch;
+  }
+}
+
+#else
+
+IoUring::IoUring(unsigned entries) {}
+
+IoUring::~IoUring() = default;
+
+void IoUring::Unmap() {}
+
+void IoUring::SubmitAndWait(int fd, bool write, std::vector<Request> *requests) {
+  for (auto &request : *requests) {
+    request.result_ = -ENOSYS;
+  }
+}
+
+#endif
+
+}  // namespace bustub
@@ -9,11 +9,17 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
 #include <string>
 
 #include "common/exception.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/external_sorter.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
@@ -23,13 +29,14 @@ thread_local int BPLUSTREE_TYPE::rootLockedCnt = 0;
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool unique)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      unique_(unique) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::clearLockedPages(LockType lockType, Transaction *transaction) {
@@ -89,7 +96,7 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return this->root_page_id_ == INVALID_PAG
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values that associated with input key
  * This method is used for point query
  * @return : true means key exists
  */
@@ -97,7 +104,26 @@ INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
   // 0. init result
   result->resize(1);
-  // 1. find leaf
+  // 1. find leaf optimistically, readers take no latch and only look at a validated copy of the leaf
+  alignas(std::max_align_t) char leaf_data[PAGE_SIZE];
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; ++attempt) {
+    page_id_t leaf_page_id;
+    if (!OptimisticFindLeafPage(key, false, leaf_data, &leaf_page_id)) {
+      continue;
+    }
+    LeafPage *leafPage = reinterpret_cast<LeafPage *>(leaf_data);
+    bool isExist = leaf_page_id != INVALID_PAGE_ID && leafPage->Lookup(key, &(*result)[0], comparator_);
+    if (isExist && this->IsPostingList((*result)[0])) {
+      // a posting list is only consistent under the leaf latch
+      break;
+    }
+    if (!isExist) {
+      // project3 need clear result
+      result->clear();
+    }
+    return isExist;
+  }
+  // 2. writers keep getting in the way, fall back to latch crabbing
   this->lockRoot(LockType::READ);
   LeafPage *leafPage = reinterpret_cast<LeafPage *>(getFindLeafPageWithLock(key, false));
   if (leafPage == nullptr) {
@@ -105,19 +131,76 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
     result->clear();
     return false;
   }
-  // 2. lookup leaf
+  // 3. lookup leaf
   bool isExist = leafPage->Lookup(key, &(*result)[0], comparator_);
   if (!isExist) {
     // project3 need clear result
     result->clear();
+  } else if (this->IsPostingList((*result)[0])) {
+    page_id_t postingPageId = (*result)[0].GetPageId();
+    result->clear();
+    BPlusTreePostingPage::GetRIDs(this->buffer_pool_manager_, postingPageId, result);
   }
-  // 3. unpin leaf
+  // 4. unpin leaf
   this->unlock(reinterpret_cast<Page *>(leafPage), LockType::READ);
   this->buffer_pool_manager_->UnpinPage(leafPage->GetPageId(), true);
   this->tryUnlockRoot(LockType::READ);
   return isExist;
 }
 
+/*
+ * Look up a batch of keys, sharing the descent between keys that are close
+ * to each other
+ * @return : the number of keys found
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                                 Transaction *transaction) {
+  results->assign(keys.size(), std::vector<ValueType>());
+  // 0. visit the keys in order, so that the keys of one leaf come one after another
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return this->comparator_(keys[a], keys[b]) < 0; });
+  std::vector<OptimisticPathLevel> path;
+  size_t found = 0;
+  size_t next = 0;
+  while (next < order.size()) {
+    // 1. copy the leaf of the next key, starting from the lowest page of the path that still covers it
+    bool copied = false;
+    for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS && !copied; ++attempt) {
+      copied = this->OptimisticFindLeafPath(keys[order[next]], &path);
+    }
+    if (!copied) {
+      // 2. writers keep getting in the way, look this key up on its own
+      if (this->GetValue(keys[order[next]], &(*results)[order[next]], transaction)) {
+        found++;
+      }
+      next++;
+      continue;
+    }
+    if (path.empty()) {
+      break;
+    }
+    // 3. every following key below the upper bound of the leaf is in the leaf or nowhere
+    const OptimisticPathLevel &leaf = path.back();
+    const LeafPage *leafPage = reinterpret_cast<const LeafPage *>(leaf.data_);
+    do {
+      ValueType value;
+      if (leafPage->Lookup(keys[order[next]], &value, comparator_)) {
+        if (this->IsPostingList(value)) {
+          // a posting list is only consistent under the leaf latch
+          this->GetValue(keys[order[next]], &(*results)[order[next]], transaction);
+        } else {
+          (*results)[order[next]].push_back(value);
+        }
+        found++;
+      }
+      next++;
+    } while (next < order.size() && (!leaf.has_upper_ || this->comparator_(keys[order[next]], leaf.upper_) < 0));
+  }
+  return found;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -125,12 +208,33 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: in a unique tree, if user try to insert duplicate keys return
+ * false; otherwise return false only if the pair is already there.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  // 0. if is empty StartNewTree
+  // 0. most inserts do not split the leaf, try with read latches on the way down first
+  Page *page = this->optimisticFindLeafPageWithLock(key);
+  if (page != nullptr) {
+    LeafPage *leafPage = reinterpret_cast<LeafPage *>(page);
+    ValueType oldValue;
+    bool isExist = leafPage->Lookup(key, &oldValue, comparator_);
+    bool isSafe = leafPage->GetSize() + 1 < leafPage->GetMaxSize();
+    bool isInserted = false;
+    if (isExist) {
+      // a duplicate key never changes the structure of the tree
+      isInserted = this->InsertIntoPostingList(leafPage, key, oldValue, value);
+    } else if (isSafe) {
+      leafPage->Insert(key, value, comparator_);
+      isInserted = true;
+    }
+    this->unlock(page, LockType::WRITE);
+    this->buffer_pool_manager_->UnpinPage(page->GetPageId(), isInserted);
+    if (isExist || isSafe) {
+      return isInserted;
+    }
+  }
+  // 1. if is empty StartNewTree
   this->lockRoot(LockType::WRITE);
   if (this->IsEmpty()) {
     this->StartNewTree(key, value);
@@ -157,16 +261,18 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
     return;
   }
   LeafPage *root = reinterpret_cast<LeafPage *>(newPage);
-  // 1. init this page
+  // 1. init this page, optimistic readers may find it as soon as it is the root
   // whether remain 1 place: first insert, then think about split?
+  this->lock(newPage, LockType::WRITE);
+  root->Init(newPageID, bustub::INVALID_PAGE_ID, leaf_max_size_);
   this->root_page_id_ = newPageID;
-  root->Init(this->root_page_id_, bustub::INVALID_PAGE_ID, leaf_max_size_);
   // 2. update root page id
   this->UpdateRootPageId(true);
   // 3. insert pair in root page
   root->Insert(key, value, this->comparator_);
+  this->unlock(newPage, LockType::WRITE);
   // 4. unpin root page
-  this->buffer_pool_manager_->UnpinPage(this->root_page_id_, true);
+  this->buffer_pool_manager_->UnpinPage(newPageID, true);
 }
 
 /*
@@ -174,18 +280,20 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  * User needs to first find the right leaf page as insertion target, then look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immdiately, otherwise insert entry. Remember to deal with split if necessary.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: in a unique tree, if user try to insert duplicate keys return
+ * false; otherwise return false only if the pair is already there.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
   // 0. get leaf
   LeafPage *leafPage = reinterpret_cast<LeafPage *>(this->insertFindLeafPageWithLock(key, transaction));
-  // 1. if key isExist return false
-  bool isExist = leafPage->Lookup(key, &(const_cast<ValueType &>(value)), comparator_);
+  // 1. if key isExist, add the value to its posting list, or return false in a unique tree
+  ValueType oldValue;
+  bool isExist = leafPage->Lookup(key, &oldValue, comparator_);
   if (isExist) {
+    bool isInserted = this->InsertIntoPostingList(leafPage, key, oldValue, value);
     this->clearLockedPages(LockType::WRITE, transaction);
-    return false;
+    return isInserted;
   }
   // 2. else insert key value first
   leafPage->Insert(key, value, comparator_);
@@ -281,6 +389,183 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   this->InsertIntoParent(parentPage, internalPage2->KeyAt(0), internalPage2, transaction);
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Sort the pairs, then build the tree bottom-up. Only the right most page of
+ * each level is pinned while it is filled; once full it is appended to the
+ * level above and a new one is started. At the end, the last page of each
+ * level is brought up to min size from its left sibling and the only page of
+ * the top level becomes the root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(const std::function<bool(MappingType *)> &next, double fill_factor,
+                              int sort_buffer_pages) {
+  if (!this->IsEmpty()) {
+    throw Exception(ExceptionType::INVALID, "can only bulk load an empty b+ tree");
+  }
+  // 0. sort the pairs, runs that do not fit in memory are spilled to temporary pages
+  auto less = [this](const MappingType &a, const MappingType &b) { return this->comparator_(a.first, b.first) < 0; };
+  ExternalSorter<MappingType, decltype(less)> sorter(this->buffer_pool_manager_, less, sort_buffer_pages);
+  MappingType item;
+  while (next(&item)) {
+    sorter.Add(item);
+  }
+  sorter.Sort();
+  // 1. pages are filled up to the fill factor, but never below their min size
+  int leafFill = std::clamp(static_cast<int>(fill_factor * (leaf_max_size_ - 1)), std::max(leaf_max_size_ / 2, 1),
+                            leaf_max_size_ - 1);
+  int internalFill = std::clamp(static_cast<int>(fill_factor * internal_max_size_),
+                                std::max(internal_max_size_ / 2, 2), internal_max_size_);
+  // 2. fill the leaves left to right, levels[0] is the leaf level
+  std::vector<BulkLoadLevel> levels;
+  KeyType lastKey;
+  while (sorter.Next(&item)) {
+    if (!levels.empty() && this->comparator_(item.first, lastKey) == 0) {
+      // the key is the last one of the leaf being filled
+      LeafPage *leaf = reinterpret_cast<LeafPage *>(levels[0].page_);
+      ValueType oldValue;
+      leaf->Lookup(item.first, &oldValue, this->comparator_);
+      this->InsertIntoPostingList(leaf, item.first, oldValue, item.second);
+      continue;
+    }
+    lastKey = item.first;
+    LeafPage *leaf = levels.empty() ? nullptr : reinterpret_cast<LeafPage *>(levels[0].page_);
+    if (leaf == nullptr || leaf->GetSize() == leafFill) {
+      page_id_t newPageID;
+      Page *newPage = this->BulkLoadNewPage(&newPageID);
+      reinterpret_cast<LeafPage *>(newPage)->Init(newPageID, INVALID_PAGE_ID, leaf_max_size_);
+      if (leaf == nullptr) {
+        levels.emplace_back();
+      } else {
+        leaf->SetNextPageId(newPageID);
+        this->BulkLoadFinishPage(&levels, 0, internalFill);
+      }
+      levels[0].page_ = newPage;
+      levels[0].first_key_ = item.first;
+      leaf = reinterpret_cast<LeafPage *>(newPage);
+    }
+    leaf->Insert(item.first, item.second, this->comparator_);
+  }
+  // 3. finish the last page of every level bottom up, until the level that has a single page
+  for (size_t level = 0; level < levels.size(); level++) {
+    if (levels[level].prev_page_id_ != INVALID_PAGE_ID) {
+      if (this->BulkLoadFixLastPage(&levels, level)) {
+        this->BulkLoadFinishPage(&levels, level, internalFill);
+      }
+      continue;
+    }
+    // 4. the single page is the root, unless the last page below was merged into its only sibling
+    BPlusTreePage *root = reinterpret_cast<BPlusTreePage *>(levels[level].page_);
+    page_id_t rootPageID = root->GetPageId();
+    if (!root->IsLeafPage() && root->GetSize() == 1) {
+      page_id_t childPageID = reinterpret_cast<InternalPage *>(root)->ValueAt(0);
+      this->buffer_pool_manager_->UnpinPage(rootPageID, false);
+      this->buffer_pool_manager_->DeletePage(rootPageID);
+      rootPageID = childPageID;
+      Page *childPage = this->buffer_pool_manager_->FetchPage(rootPageID);
+      assert(childPage != nullptr);
+      reinterpret_cast<BPlusTreePage *>(childPage)->SetParentPageId(INVALID_PAGE_ID);
+    }
+    this->buffer_pool_manager_->UnpinPage(rootPageID, true);
+    this->root_page_id_ = rootPageID;
+    this->UpdateRootPageId(true);
+    break;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::BulkLoadAppend(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &key,
+                                         page_id_t child_page_id, int internal_fill) {
+  if (level == levels->size()) {
+    levels->emplace_back();
+  }
+  InternalPage *node = reinterpret_cast<InternalPage *>((*levels)[level].page_);
+  if (node != nullptr && node->GetSize() < internal_fill) {
+    node->IncreaseSize(1);
+    node->SetKeyAt(node->GetSize() - 1, key);
+    node->SetValueAt(node->GetSize() - 1, child_page_id);
+    return node->GetPageId();
+  }
+  if (node != nullptr) {
+    this->BulkLoadFinishPage(levels, level, internal_fill);
+  }
+  page_id_t newPageID;
+  Page *newPage = this->BulkLoadNewPage(&newPageID);
+  node = reinterpret_cast<InternalPage *>(newPage);
+  node->Init(newPageID, INVALID_PAGE_ID, internal_max_size_);
+  node->IncreaseSize(1);
+  node->SetValueAt(0, child_page_id);
+  (*levels)[level].page_ = newPage;
+  (*levels)[level].first_key_ = key;
+  return newPageID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoadFinishPage(std::vector<BulkLoadLevel> *levels, size_t level, int internal_fill) {
+  BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>((*levels)[level].page_);
+  // levels may grow, which moves the key
+  KeyType firstKey = (*levels)[level].first_key_;
+  page_id_t parentPageID = this->BulkLoadAppend(levels, level + 1, firstKey, node->GetPageId(), internal_fill);
+  node->SetParentPageId(parentPageID);
+  (*levels)[level].prev_page_id_ = node->GetPageId();
+  (*levels)[level].page_ = nullptr;
+  this->buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoadFixLastPage(std::vector<BulkLoadLevel> *levels, size_t level) {
+  BulkLoadLevel &last = (*levels)[level];
+  BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(last.page_);
+  if (node->GetSize() >= node->GetMinSize()) {
+    return true;
+  }
+  Page *siblingPage = this->buffer_pool_manager_->FetchPage(last.prev_page_id_);
+  if (siblingPage == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+  }
+  BPlusTreePage *sibling = reinterpret_cast<BPlusTreePage *>(siblingPage);
+  int capacity = node->IsLeafPage() ? leaf_max_size_ - 1 : internal_max_size_;
+  // 0. merge into the left sibling if both fit in one page
+  if (sibling->GetSize() + node->GetSize() <= capacity) {
+    if (node->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(node)->MoveAllTo(reinterpret_cast<LeafPage *>(sibling));
+    } else {
+      reinterpret_cast<InternalPage *>(node)->MoveAllTo(reinterpret_cast<InternalPage *>(sibling), last.first_key_,
+                                                        this->buffer_pool_manager_);
+    }
+    this->buffer_pool_manager_->UnpinPage(sibling->GetPageId(), true);
+    this->buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
+    this->buffer_pool_manager_->DeletePage(node->GetPageId());
+    last.page_ = nullptr;
+    return false;
+  }
+  // 1. otherwise split the entries of both evenly, the last page gets the tail of its sibling
+  int moves = (sibling->GetSize() + node->GetSize()) / 2 - node->GetSize();
+  for (int i = 0; i < moves; i++) {
+    if (node->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(sibling)->MoveLastToFrontOf(reinterpret_cast<LeafPage *>(node));
+      last.first_key_ = reinterpret_cast<LeafPage *>(node)->KeyAt(0);
+    } else {
+      reinterpret_cast<InternalPage *>(sibling)->MoveLastToFrontOf(reinterpret_cast<InternalPage *>(node),
+                                                                   last.first_key_, this->buffer_pool_manager_);
+      last.first_key_ = reinterpret_cast<InternalPage *>(node)->KeyAt(0);
+    }
+  }
+  this->buffer_pool_manager_->UnpinPage(sibling->GetPageId(), true);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::BulkLoadNewPage(page_id_t *page_id) {
+  Page *newPage = this->buffer_pool_manager_->NewPage(page_id);
+  if (newPage == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+  }
+  return newPage;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -293,23 +578,75 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  // 0. if tree is empty, return
+  this->RemoveValue(key, nullptr, transaction);
+}
+
+/*
+ * Delete the key & value pair, other values of the same key stay in the tree
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  this->RemoveValue(key, &value, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveValue(const KeyType &key, const ValueType *value, Transaction *transaction) {
+  // 0. most removes do not merge the leaf, try with read latches on the way down first
+  Page *page = this->optimisticFindLeafPageWithLock(key);
+  if (page != nullptr) {
+    LeafPage *leafPage = reinterpret_cast<LeafPage *>(page);
+    ValueType oldValue;
+    bool isExist = leafPage->Lookup(key, &oldValue, comparator_);
+    bool isPostingList = isExist && this->IsPostingList(oldValue);
+    if (isPostingList && value != nullptr) {
+      // the key keeps at least one value, the structure of the tree does not change
+      this->RemoveFromPostingList(leafPage, key, oldValue, *value);
+      this->unlock(page, LockType::WRITE);
+      this->buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      return;
+    }
+    isExist = isExist && (isPostingList || value == nullptr || oldValue == *value);
+    bool isSafe = leafPage->GetSize() - 1 >= leafPage->GetMinSize();
+    if (isExist && isSafe) {
+      leafPage->RemoveAndDeleteRecord(key, comparator_);
+    }
+    this->unlock(page, LockType::WRITE);
+    this->buffer_pool_manager_->UnpinPage(page->GetPageId(), isExist && isSafe);
+    if (isExist && isSafe && isPostingList) {
+      this->DeletePostingList(oldValue.GetPageId());
+    }
+    if (!isExist || isSafe) {
+      return;
+    }
+  }
+  // 1. if tree is empty, return
   this->lockRoot(LockType::WRITE);
   if (this->IsEmpty()) {
     this->tryUnlockRoot(LockType::WRITE);
     return;
   }
-  // 1. else find the leaf, and key don't exist in leaf, return
+  // 2. else find the leaf, and key don't exist in leaf, return
   LeafPage *leafPage = reinterpret_cast<LeafPage *>(this->removeFindLeafPageWithLock(key, transaction));
   assert(leafPage != nullptr);
-  ValueType value;
-  if (!leafPage->Lookup(key, &value, this->comparator_)) {
+  ValueType oldValue;
+  if (!leafPage->Lookup(key, &oldValue, this->comparator_)) {
+    this->clearLockedPages(LockType::WRITE, transaction);
+    return;
+  }
+  bool isPostingList = this->IsPostingList(oldValue);
+  if (value != nullptr && (isPostingList || !(oldValue == *value))) {
+    if (isPostingList) {
+      this->RemoveFromPostingList(leafPage, key, oldValue, *value);
+    }
     this->clearLockedPages(LockType::WRITE, transaction);
     return;
   }
   // 3. delete key in leafpage
   this->delete_entry(leafPage, key, transaction);
   this->clearLockedPages(LockType::WRITE, transaction);
+  if (isPostingList) {
+    this->DeletePostingList(oldValue.GetPageId());
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -547,6 +884,150 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
   return false;
 }
 
+/*****************************************************************************
+ * POSTING LIST
+ *****************************************************************************/
+/*
+ * The first duplicate of a key moves its value and the new one into a new
+ * posting page, and the leaf keeps a marker to it. Later duplicates go to the
+ * first page of the list with room, or to a new page at its end.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoPostingList(LeafPage *leaf, const KeyType &key, const ValueType &old_value,
+                                           const ValueType &value) {
+  if (this->unique_) {
+    return false;
+  }
+  // 0. turn the value of the key into a posting list
+  if (!this->IsPostingList(old_value)) {
+    if (old_value == value) {
+      return false;
+    }
+    page_id_t newPageID;
+    Page *newPage = this->buffer_pool_manager_->NewPage(&newPageID);
+    if (newPage == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+    }
+    BPlusTreePostingPage *postingPage = reinterpret_cast<BPlusTreePostingPage *>(newPage->GetData());
+    postingPage->Init(newPageID);
+    postingPage->Append(old_value);
+    postingPage->Append(value);
+    this->buffer_pool_manager_->UnpinPage(newPageID, true);
+    leaf->SetValueAt(leaf->KeyIndex(key, this->comparator_), BPlusTreePostingPage::PostingList(newPageID));
+    return true;
+  }
+  // 1. look for the value in the whole list, and for a page with room on the way
+  page_id_t freePageID = INVALID_PAGE_ID;
+  page_id_t lastPageID = INVALID_PAGE_ID;
+  for (page_id_t pageID = old_value.GetPageId(); pageID != INVALID_PAGE_ID;) {
+    Page *page = this->buffer_pool_manager_->FetchPage(pageID);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+    }
+    BPlusTreePostingPage *postingPage = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    bool isExist = postingPage->Find(value) >= 0;
+    if (freePageID == INVALID_PAGE_ID && !postingPage->IsFull()) {
+      freePageID = pageID;
+    }
+    lastPageID = pageID;
+    pageID = postingPage->GetNextPageId();
+    this->buffer_pool_manager_->UnpinPage(lastPageID, false);
+    if (isExist) {
+      return false;
+    }
+  }
+  // 2. every page is full, chain a new one after the last
+  Page *page;
+  if (freePageID == INVALID_PAGE_ID) {
+    page = this->buffer_pool_manager_->NewPage(&freePageID);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't new page from buffer pool manager");
+    }
+    reinterpret_cast<BPlusTreePostingPage *>(page->GetData())->Init(freePageID);
+    Page *lastPage = this->buffer_pool_manager_->FetchPage(lastPageID);
+    assert(lastPage != nullptr);
+    reinterpret_cast<BPlusTreePostingPage *>(lastPage->GetData())->SetNextPageId(freePageID);
+    this->buffer_pool_manager_->UnpinPage(lastPageID, true);
+  } else {
+    page = this->buffer_pool_manager_->FetchPage(freePageID);
+    assert(page != nullptr);
+  }
+  reinterpret_cast<BPlusTreePostingPage *>(page->GetData())->Append(value);
+  this->buffer_pool_manager_->UnpinPage(freePageID, true);
+  return true;
+}
+
+/*
+ * Pages emptied by the removal are unlinked and deleted. When a single value
+ * is left, it goes back into the leaf and the last page is deleted too.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveFromPostingList(LeafPage *leaf, const KeyType &key, const ValueType &old_value,
+                                           const ValueType &value) {
+  int index = leaf->KeyIndex(key, this->comparator_);
+  page_id_t headPageID = old_value.GetPageId();
+  // 0. find the page of the value and remove it there
+  page_id_t prevPageID = INVALID_PAGE_ID;
+  for (page_id_t pageID = headPageID; pageID != INVALID_PAGE_ID;) {
+    Page *page = this->buffer_pool_manager_->FetchPage(pageID);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+    }
+    BPlusTreePostingPage *postingPage = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    page_id_t nextPageID = postingPage->GetNextPageId();
+    int valueIndex = postingPage->Find(value);
+    if (valueIndex < 0) {
+      this->buffer_pool_manager_->UnpinPage(pageID, false);
+      prevPageID = pageID;
+      pageID = nextPageID;
+      continue;
+    }
+    postingPage->RemoveAt(valueIndex);
+    bool isEmpty = postingPage->GetSize() == 0;
+    this->buffer_pool_manager_->UnpinPage(pageID, !isEmpty);
+    if (!isEmpty) {
+      break;
+    }
+    // 1. unlink the empty page
+    this->buffer_pool_manager_->DeletePage(pageID);
+    if (prevPageID == INVALID_PAGE_ID) {
+      headPageID = nextPageID;
+      leaf->SetValueAt(index, BPlusTreePostingPage::PostingList(headPageID));
+    } else {
+      Page *prevPage = this->buffer_pool_manager_->FetchPage(prevPageID);
+      assert(prevPage != nullptr);
+      reinterpret_cast<BPlusTreePostingPage *>(prevPage->GetData())->SetNextPageId(nextPageID);
+      this->buffer_pool_manager_->UnpinPage(prevPageID, true);
+    }
+    break;
+  }
+  // 2. no page is empty, so a single value left is alone in the head page
+  Page *headPage = this->buffer_pool_manager_->FetchPage(headPageID);
+  assert(headPage != nullptr);
+  BPlusTreePostingPage *postingPage = reinterpret_cast<BPlusTreePostingPage *>(headPage->GetData());
+  if (postingPage->GetSize() == 1 && postingPage->GetNextPageId() == INVALID_PAGE_ID) {
+    leaf->SetValueAt(index, postingPage->RIDAt(0));
+    this->buffer_pool_manager_->UnpinPage(headPageID, false);
+    this->buffer_pool_manager_->DeletePage(headPageID);
+    return;
+  }
+  this->buffer_pool_manager_->UnpinPage(headPageID, false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePostingList(page_id_t page_id) {
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = this->buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+    }
+    page_id_t nextPageID = reinterpret_cast<BPlusTreePostingPage *>(page->GetData())->GetNextPageId();
+    this->buffer_pool_manager_->UnpinPage(page_id, false);
+    this->buffer_pool_manager_->DeletePage(page_id);
+    page_id = nextPageID;
+  }
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -556,18 +1037,7 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
-  KeyType key;
-  this->lockRoot(LockType::READ);
-  LeafPage *leafPage = reinterpret_cast<LeafPage *>(this->getFindLeafPageWithLock(key, true));
-  if (leafPage == nullptr) {
-    return INDEXITERATOR_TYPE(this->buffer_pool_manager_, INVALID_PAGE_ID, 0);
-  }
-  page_id_t pageId = leafPage->GetPageId();
-  this->unlock(reinterpret_cast<Page *>(leafPage), LockType::READ);
-  this->tryUnlockRoot(LockType::READ);
-  return INDEXITERATOR_TYPE(this->buffer_pool_manager_, pageId, 0);
-}
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() { return this->Begin(nullptr, nullptr); }
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -575,18 +1045,26 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
-  this->lockRoot(LockType::READ);
-  LeafPage *leafPage = reinterpret_cast<LeafPage *>(this->getFindLeafPageWithLock(key, false));
-  if (leafPage == nullptr) {
-    return INDEXITERATOR_TYPE(this->buffer_pool_manager_, INVALID_PAGE_ID, 0);
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return this->Begin(&key, nullptr); }
+
+/*
+ * Input parameters are the low key and the high key, both optional, find the
+ * leaf page that contains the low key first, then construct an index iterator
+ * that stops after the high key
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType *key, const KeyType *end_key) {
+  // the iterator copies the pairs of the leaf under its latch, so the leaf is found with latch crabbing rather than
+  // optimistically
+  Page *page = this->findIteratorLeafPage(key == nullptr ? KeyType() : *key, key == nullptr);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
   }
-  page_id_t pageId = leafPage->GetPageId();
-  int index = leafPage->KeyIndex(key, this->comparator_);
-  assert(index < leafPage->GetSize());
-  this->unlock(reinterpret_cast<Page *>(leafPage), LockType::READ);
-  this->tryUnlockRoot(LockType::READ);
-  return INDEXITERATOR_TYPE(this->buffer_pool_manager_, pageId, index);
+  int index = key == nullptr ? 0 : reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(*key, this->comparator_);
+  return INDEXITERATOR_TYPE(this->buffer_pool_manager_, page, index, end_key, &this->comparator_,
+                            [this](const KeyType &lastKey) { return this->findIteratorLeafPage(lastKey, false); },
+                            this->unique_);
 }
 
 /*
@@ -595,7 +1073,7 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(this->buffer_pool_manager_, INVALID_PAGE_ID, 0); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(); }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -655,6 +1133,180 @@ Page *BPLUSTREE_TYPE::getFindLeafPageWithLock(const KeyType &key, bool leftMost)
   return pagePtr;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::findIteratorLeafPage(const KeyType &key, bool leftMost) {
+  this->lockRoot(LockType::READ);
+  Page *page = this->getFindLeafPageWithLock(key, leftMost);
+  if (page != nullptr) {
+    this->tryUnlockRoot(LockType::READ);
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::OptimisticFindLeafPage(const KeyType &key, bool leftMost, char *leaf_data,
+                                            page_id_t *leaf_page_id) {
+  page_id_t pageId = this->root_page_id_;
+  *leaf_page_id = pageId;
+  if (pageId == INVALID_PAGE_ID) {
+    return true;
+  }
+  Page *parentPage = nullptr;
+  uint64_t parentVersion = 0;
+  while (true) {
+    Page *page;
+    uint64_t version;
+    if (!this->OptimisticReadPage(pageId, leaf_data, &page, &version)) {
+      return false;
+    }
+    BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(leaf_data);
+    if (parentPage == nullptr) {
+      // the root may have been split or collapsed since root_page_id_ was read
+      if (!node->IsRootPage() || this->root_page_id_ != pageId) {
+        return false;
+      }
+    } else if (!parentPage->ValidateVersion(parentVersion)) {
+      return false;
+    }
+    if (node->IsLeafPage()) {
+      *leaf_page_id = pageId;
+      return true;
+    }
+    InternalPage *internalPage = reinterpret_cast<InternalPage *>(leaf_data);
+    pageId = leftMost ? internalPage->ValueAt(0) : internalPage->Lookup(key, comparator_);
+    parentPage = page;
+    parentVersion = version;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::OptimisticFindLeafPath(const KeyType &key, std::vector<OptimisticPathLevel> *path) {
+  // 0. keep the path down to the lowest internal page that covers the key and was not changed since it was copied, the
+  // keys come in ascending order so the key is above the lower bound of every page of the path
+  while (!path->empty()) {
+    OptimisticPathLevel &level = path->back();
+    bool covers = !level.has_upper_ || comparator_(key, level.upper_) < 0;
+    if (covers && !reinterpret_cast<BPlusTreePage *>(level.data_)->IsLeafPage() &&
+        level.page_->ValidateVersion(level.version_)) {
+      break;
+    }
+    path->pop_back();
+  }
+  // 1. descend from there, or from the root, validating every parent once its child is copied
+  while (true) {
+    page_id_t pageId;
+    Page *parentPage = nullptr;
+    uint64_t parentVersion = 0;
+    bool hasUpper = false;
+    KeyType upper;
+    if (path->empty()) {
+      pageId = this->root_page_id_;
+      if (pageId == INVALID_PAGE_ID) {
+        return true;
+      }
+    } else {
+      const OptimisticPathLevel &parent = path->back();
+      const InternalPage *internalPage = reinterpret_cast<const InternalPage *>(parent.data_);
+      pageId = internalPage->Lookup(key, comparator_);
+      int index = internalPage->ValueIndex(pageId);
+      hasUpper = index + 1 < internalPage->GetSize() || parent.has_upper_;
+      upper = index + 1 < internalPage->GetSize() ? internalPage->KeyAt(index + 1) : parent.upper_;
+      parentPage = parent.page_;
+      parentVersion = parent.version_;
+    }
+    path->emplace_back();
+    OptimisticPathLevel &level = path->back();
+    bool valid = this->OptimisticReadPage(pageId, level.data_, &level.page_, &level.version_);
+    BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(level.data_);
+    if (valid && parentPage == nullptr) {
+      // the root may have been split or collapsed since root_page_id_ was read
+      valid = node->IsRootPage() && this->root_page_id_ == pageId;
+    } else if (valid) {
+      valid = parentPage->ValidateVersion(parentVersion);
+    }
+    if (!valid) {
+      path->clear();
+      return false;
+    }
+    level.has_upper_ = hasUpper;
+    level.upper_ = upper;
+    if (node->IsLeafPage()) {
+      return true;
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::OptimisticReadPage(page_id_t page_id, char *data, Page **page, uint64_t *version) {
+  // Resident pages are copied straight from their frame, which writes nothing, not even a pin count.
+  *page = this->buffer_pool_manager_->PeekPage(page_id);
+  if (*page != nullptr) {
+    *version = (*page)->GetVersion();
+    if (*version % 2 != 0) {
+      return false;
+    }
+    memcpy(data, (*page)->GetData(), PAGE_SIZE);
+    bool samePage = (*page)->GetPageId() == page_id;
+    return (*page)->ValidateVersion(*version) && samePage;
+  }
+  // Writers only change the version under the write latch, and a pinned frame is not replaced.
+  *page = this->buffer_pool_manager_->FetchPage(page_id);
+  if (*page == nullptr) {
+    return false;
+  }
+  this->lock(*page, LockType::READ);
+  *version = (*page)->GetVersion();
+  memcpy(data, (*page)->GetData(), PAGE_SIZE);
+  this->unlock(*page, LockType::READ);
+  this->buffer_pool_manager_->UnpinPage(page_id, false);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::optimisticFindLeafPageWithLock(const KeyType &key) {
+  page_id_t curPageID = this->root_page_id_;
+  if (curPageID == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *pagePtr = this->buffer_pool_manager_->FetchPage(curPageID);
+  if (pagePtr == nullptr) {
+    return nullptr;
+  }
+  this->lock(pagePtr, LockType::READ);
+  // 0. the root may have changed before it was latched, a latched root stays the root. A root leaf is left to the
+  // pessimistic path, which may have to replace it.
+  if (this->root_page_id_ != curPageID || reinterpret_cast<BPlusTreePage *>(pagePtr)->IsLeafPage()) {
+    this->unlock(pagePtr, LockType::READ);
+    this->buffer_pool_manager_->UnpinPage(curPageID, false);
+    return nullptr;
+  }
+  while (true) {
+    // 1. crab down with read latches
+    InternalPage *internalPage = reinterpret_cast<InternalPage *>(pagePtr);
+    page_id_t nextPageID = internalPage->Lookup(key, comparator_);
+    Page *childPtr = this->buffer_pool_manager_->FetchPage(nextPageID);
+    if (childPtr == nullptr) {
+      this->unlock(pagePtr, LockType::READ);
+      this->buffer_pool_manager_->UnpinPage(curPageID, false);
+      return nullptr;
+    }
+    this->lock(childPtr, LockType::READ);
+    bool isLeaf = reinterpret_cast<BPlusTreePage *>(childPtr)->IsLeafPage();
+    if (isLeaf) {
+      // 2. upgrade the leaf latch while the parent is still latched
+      this->unlock(childPtr, LockType::READ);
+      this->lock(childPtr, LockType::WRITE);
+    }
+    this->unlock(pagePtr, LockType::READ);
+    this->buffer_pool_manager_->UnpinPage(curPageID, false);
+    if (isLeaf) {
+      return childPtr;
+    }
+    pagePtr = childPtr;
+    curPageID = nextPageID;
+  }
+}
+
 /*
  * call this function with Root Lock !!! Be carefully!!!
  */
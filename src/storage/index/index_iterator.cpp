@@ -2,6 +2,7 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <utility>
 
 #include "storage/index/index_iterator.h"
 
@@ -12,44 +13,165 @@ namespace bustub {
  * set your own input parameters
  */
 INDEX_TEMPLATE_ARGUMENTS
-// wang qi think don't implement it is ok!
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, page_id_t page_id, int index)
-    : bpm_(bpm), page_id_(page_id), index_(index) {}
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, Page *page, int index, const KeyType *end_key,
+                                  const KeyComparator *comparator, LeafFinder find_leaf, bool unique)
+    : bpm_(bpm),
+      has_end_key_(end_key != nullptr),
+      comparator_(comparator),
+      find_leaf_(std::move(find_leaf)),
+      unique_(unique) {
+  if (end_key != nullptr) {
+    this->end_key_ = *end_key;
+  }
+  this->Load(page, index);
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept { *this = std::move(other); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+  if (this != &other) {
+    this->bpm_ = other.bpm_;
+    this->page_id_ = other.page_id_;
+    this->next_page_id_ = other.next_page_id_;
+    this->index_ = other.index_;
+    this->has_end_key_ = other.has_end_key_;
+    this->end_key_ = other.end_key_;
+    this->comparator_ = other.comparator_;
+    this->find_leaf_ = std::move(other.find_leaf_);
+    this->read_ahead_end_ = other.read_ahead_end_;
+    this->unique_ = other.unique_;
+    this->items_ = std::move(other.items_);
+    this->last_items_ = other.last_items_;
+    other.End();
+  }
+  return *this;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::isEnd() { return this->page_id_ == INVALID_PAGE_ID; }
 
 INDEX_TEMPLATE_ARGUMENTS
 const MappingType &INDEXITERATOR_TYPE::operator*() {
-  assert(this->page_id_ != INVALID_PAGE_ID);
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leafNode =
-      reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(this->bpm_->FetchPage(this->page_id_));
-  const MappingType &mappingType = leafNode->GetItem(this->index_);
-  this->bpm_->UnpinPage(this->page_id_, false);
-  return mappingType;
+  assert(!this->isEnd());
+  return this->items_[this->index_];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-  assert(this->page_id_ != INVALID_PAGE_ID);
-  page_id_t old_page_id = this->page_id_;
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leafNode =
-      reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(this->bpm_->FetchPage(this->page_id_));
-  this->index_++;
-  if (this->index_ == leafNode->GetSize()) {
-    this->page_id_ = leafNode->GetNextPageId();
-    this->index_ = 0;
+  assert(!this->isEnd());
+  if (++this->index_ < static_cast<int>(this->items_.size())) {
+    return *this;
+  }
+  if (this->last_items_) {
+    this->End();
+    return *this;
   }
-  this->bpm_->UnpinPage(old_page_id, false);
+  // the leaf may have changed since the pairs were copied, go on after the last key copied from the root
+  this->read_ahead_end_ = this->bpm_->ReadAhead(this->page_id_, this->next_page_id_, this->read_ahead_end_);
+  int index;
+  Page *page = this->FindAfter(this->items_.back().first, &index);
+  this->Load(page, index);
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Load(Page *page, int index) {
+  this->items_.clear();
+  this->index_ = 0;
+  while (page != nullptr) {
+    LeafPage *leafPage = reinterpret_cast<LeafPage *>(page->GetData());
+    // 1. copy the pairs of this leaf up to the end key
+    if (index < leafPage->GetSize()) {
+      this->page_id_ = page->GetPageId();
+      this->next_page_id_ = leafPage->GetNextPageId();
+      this->last_items_ = this->next_page_id_ == INVALID_PAGE_ID;
+      for (; index < leafPage->GetSize(); index++) {
+        const MappingType &item = leafPage->GetItem(index);
+        if (this->has_end_key_ && (*this->comparator_)(item.first, this->end_key_) > 0) {
+          this->last_items_ = true;
+          break;
+        }
+        if (this->unique_ || !BPlusTreePostingPage::IsPostingList(item.second)) {
+          this->items_.push_back(item);
+          continue;
+        }
+        // the posting pages do not change while the leaf is read latched
+        std::vector<ValueType> values;
+        BPlusTreePostingPage::GetRIDs(this->bpm_, item.second.GetPageId(), &values);
+        for (const auto &value : values) {
+          this->items_.emplace_back(item.first, value);
+        }
+      }
+      this->Unlatch(page);
+      if (this->items_.empty()) {
+        this->End();
+      }
+      return;
+    }
+    page_id_t nextPageId = leafPage->GetNextPageId();
+    if (nextPageId == INVALID_PAGE_ID || leafPage->GetSize() == 0) {
+      this->Unlatch(page);
+      break;
+    }
+    // 2. hand the latch over to the next leaf
+    this->read_ahead_end_ = this->bpm_->ReadAhead(page->GetPageId(), nextPageId, this->read_ahead_end_);
+    Page *nextPage = this->bpm_->FetchPage(nextPageId);
+    if (nextPage != nullptr && nextPage->TryRLatch()) {
+      this->Unlatch(page);
+      page = nextPage;
+      index = 0;
+      continue;
+    }
+    // 3. a writer holds the next leaf and may be waiting for this one: back off, and find the first key after the
+    // last one of this leaf from the root
+    if (nextPage != nullptr) {
+      this->bpm_->UnpinPage(nextPageId, false);
+    }
+    KeyType lastKey = leafPage->KeyAt(leafPage->GetSize() - 1);
+    this->Unlatch(page);
+    page = this->FindAfter(lastKey, &index);
+  }
+  this->End();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *INDEXITERATOR_TYPE::FindAfter(const KeyType &key, int *index) {
+  Page *page = this->find_leaf_(key);
+  if (page == nullptr) {
+    return nullptr;
+  }
+  LeafPage *leafPage = reinterpret_cast<LeafPage *>(page->GetData());
+  *index = leafPage->KeyIndex(key, *this->comparator_);
+  if (*index < leafPage->GetSize() && (*this->comparator_)(leafPage->KeyAt(*index), key) == 0) {
+    (*index)++;
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Unlatch(Page *page) {
+  page_id_t page_id = page->GetPageId();
+  page->RUnlatch();
+  this->bpm_->UnpinPage(page_id, false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::End() {
+  this->page_id_ = INVALID_PAGE_ID;
+  this->next_page_id_ = INVALID_PAGE_ID;
+  this->index_ = 0;
+  this->items_.clear();
+  this->last_items_ = true;
+}
+
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
@@ -75,6 +75,16 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
   return this->array[index].second;
 }
 
+/*
+ * Helper method to set the value associated with input "index"(a.k.a array
+ * offset)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  assert(index >= 0 && index < this->GetSize());
+  this->array[index].second = value;
+}
+
 /*****************************************************************************
  * LOOKUP
  *****************************************************************************/
@@ -86,17 +96,7 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
   // find the largest index that (this->array[index].first) <= key
-  int le = 0;
-  int ri = this->GetSize() - 1;
-  while (le < ri) {
-    int mid = (le + ri + 1) / 2;
-    if (comparator(this->array[mid].first, key) > 0) {
-      ri = mid - 1;
-    } else {
-      le = mid;
-    }
-  }
-  return this->array[le].second;
+  return this->array[comparator.UpperBound(this->array, 1, this->GetSize(), key) - 1].second;
 }
 
 /*****************************************************************************
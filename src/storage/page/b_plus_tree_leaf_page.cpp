@@ -51,17 +51,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { this->n
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  int le = 0;
-  int ri = this->GetSize();
-  while (le < ri) {
-    int mid = (le + ri) / 2;
-    if (comparator(this->array[mid].first, key) < 0) {
-      le = mid + 1;
-    } else {
-      ri = mid;
-    }
-  }
-  return le;
+  return comparator.LowerBound(this->array, 0, this->GetSize(), key);
 }
 
 /*
@@ -86,6 +76,16 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
   return this->array[index];
 }
 
+/*
+ * Helper method to replace the value associated with input "index"(a.k.a
+ * array offset)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  assert(index >= 0 && index < this->GetSize());
+  this->array[index].second = value;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_posting_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+
+#include "common/exception.h"
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+void BPlusTreePostingPage::GetRIDs(BufferPoolManager *bpm, page_id_t page_id, std::vector<RID> *result) {
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = bpm->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't fetch page from buffer pool manager");
+    }
+    BPlusTreePostingPage *postingPage = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    for (int i = 0; i < postingPage->GetSize(); i++) {
+      result->push_back(postingPage->RIDAt(i));
+    }
+    page_id_t nextPageId = postingPage->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    page_id = nextPageId;
+  }
+}
+
+void BPlusTreePostingPage::Init(page_id_t page_id) {
+  this->page_id_ = page_id;
+  this->next_page_id_ = INVALID_PAGE_ID;
+  this->size_ = 0;
+}
+
+page_id_t BPlusTreePostingPage::GetPageId() const { return this->page_id_; }
+
+page_id_t BPlusTreePostingPage::GetNextPageId() const { return this->next_page_id_; }
+
+void BPlusTreePostingPage::SetNextPageId(page_id_t next_page_id) { this->next_page_id_ = next_page_id; }
+
+int BPlusTreePostingPage::GetSize() const { return this->size_; }
+
+bool BPlusTreePostingPage::IsFull() const { return this->size_ == static_cast<int>(POSTING_PAGE_SIZE); }
+
+RID BPlusTreePostingPage::RIDAt(int index) const {
+  assert(index >= 0 && index < this->size_);
+  return this->array_[index];
+}
+
+int BPlusTreePostingPage::Find(const RID &rid) const {
+  for (int i = 0; i < this->size_; i++) {
+    if (this->array_[i] == rid) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void BPlusTreePostingPage::Append(const RID &rid) {
+  assert(!this->IsFull());
+  this->array_[this->size_++] = rid;
+}
+
+void BPlusTreePostingPage::RemoveAt(int index) {
+  assert(index >= 0 && index < this->size_);
+  this->array_[index] = this->array_[--this->size_];
+}
+
+}  // namespace bustub
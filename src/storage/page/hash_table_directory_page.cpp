@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <unordered_map>
+
+#include "common/macros.h"
+#include "storage/page/hash_table_directory_page.h"
+
+namespace bustub {
+
+void HashTableDirectoryPage::Init(page_id_t page_id) {
+  this->page_id_ = page_id;
+  this->global_depth_ = 0;
+  this->local_depths_[0] = 0;
+  this->bucket_page_ids_[0] = INVALID_PAGE_ID;
+}
+
+page_id_t HashTableDirectoryPage::GetPageId() const { return this->page_id_; }
+
+uint32_t HashTableDirectoryPage::GetGlobalDepth() const { return this->global_depth_; }
+
+uint32_t HashTableDirectoryPage::GetGlobalDepthMask() const { return (1U << this->global_depth_) - 1; }
+
+uint32_t HashTableDirectoryPage::Size() const { return 1U << this->global_depth_; }
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  assert(this->global_depth_ < DIRECTORY_MAX_DEPTH);
+  uint32_t size = this->Size();
+  for (uint32_t i = 0; i < size; i++) {
+    this->local_depths_[size + i] = this->local_depths_[i];
+    this->bucket_page_ids_[size + i] = this->bucket_page_ids_[i];
+  }
+  this->global_depth_++;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() {
+  assert(this->CanShrink());
+  this->global_depth_--;
+}
+
+bool HashTableDirectoryPage::CanShrink() const {
+  if (this->global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < this->Size(); i++) {
+    if (this->local_depths_[i] == this->global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const {
+  assert(bucket_idx < this->Size());
+  return this->bucket_page_ids_[bucket_idx];
+}
+
+void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  assert(bucket_idx < this->Size());
+  this->bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
+
+uint32_t HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) const {
+  assert(bucket_idx < this->Size());
+  return this->local_depths_[bucket_idx];
+}
+
+void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth) {
+  assert(bucket_idx < this->Size() && local_depth <= this->global_depth_);
+  this->local_depths_[bucket_idx] = static_cast<uint8_t>(local_depth);
+}
+
+void HashTableDirectoryPage::VerifyIntegrity() const {
+  std::unordered_map<page_id_t, uint32_t> slotCount;
+  for (uint32_t i = 0; i < this->Size(); i++) {
+    slotCount[this->bucket_page_ids_[i]]++;
+  }
+  for (uint32_t i = 0; i < this->Size(); i++) {
+    // every slot with the same low bits has the same bucket and depth
+    uint32_t first = i & ((1U << this->local_depths_[i]) - 1);
+    BUSTUB_ASSERT(this->local_depths_[i] <= this->global_depth_, "local depth is above the global depth");
+    BUSTUB_ASSERT(this->bucket_page_ids_[i] == this->bucket_page_ids_[first], "slots of a bucket differ");
+    BUSTUB_ASSERT(this->local_depths_[i] == this->local_depths_[first], "local depths of a bucket differ");
+    BUSTUB_ASSERT(slotCount[this->bucket_page_ids_[i]] == 1U << (this->global_depth_ - this->local_depths_[i]),
+                  "a bucket is pointed to by the wrong number of slots");
+    (void)first;
+  }
+}
+
+}  // namespace bustub
@@ -294,11 +294,14 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
 
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
+  // A tuple of the same size, e.g. a batch slot refilled by a scan, keeps its storage.
+  if (!tuple->allocated_ || tuple->size_ != tuple_size) {
+    if (tuple->allocated_) {
+      delete[] tuple->data_;
+    }
+    tuple->data_ = new char[tuple_size];
   }
-  tuple->data_ = new char[tuple->size_];
+  tuple->size_ = tuple_size;
   memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
   tuple->rid_ = rid;
   tuple->allocated_ = true;
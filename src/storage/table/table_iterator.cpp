@@ -11,13 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn,
+                             std::shared_ptr<BufferAccessStrategy> strategy)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), strategy_(std::move(strategy)) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
@@ -35,19 +37,25 @@ Tuple *TableIterator::operator->() {
 
 TableIterator &TableIterator::operator++() {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  auto cur_page = static_cast<TablePage *>(
+      buffer_pool_manager->FetchPageWithStrategy(tuple_->rid_.GetPageId(), strategy_.get()));
   cur_page->RLatch();
   assert(cur_page != nullptr);  // all pages are pinned
+  read_ahead_end_ =
+      buffer_pool_manager->ReadAhead(cur_page->GetTablePageId(), cur_page->GetNextPageId(), read_ahead_end_, strategy_);
 
   RID next_tuple_rid;
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      auto next_page = static_cast<TablePage *>(
+          buffer_pool_manager->FetchPageWithStrategy(cur_page->GetNextPageId(), strategy_.get()));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
+      read_ahead_end_ = buffer_pool_manager->ReadAhead(cur_page->GetTablePageId(), cur_page->GetNextPageId(),
+                                                       read_ahead_end_, strategy_);
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
@@ -64,6 +72,33 @@ TableIterator &TableIterator::operator++() {
   return *this;
 }
 
+void TableIterator::ReadBatch(TupleBatch *batch) {
+  if (*this == table_heap_->End() || batch->IsFull()) {
+    return;
+  }
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  page_id_t page_id = tuple_->rid_.GetPageId();
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPageWithStrategy(page_id, strategy_.get()));
+  assert(cur_page != nullptr);  // all pages are pinned
+  cur_page->RLatch();
+  RID rid = tuple_->rid_;
+  while (true) {
+    if (cur_page->GetTuple(rid, batch->FreeSlot(), txn_, table_heap_->lock_manager_)) {
+      batch->AppendSlot(rid);
+    }
+    RID next_tuple_rid;
+    if (batch->IsFull() || !cur_page->GetNextTupleRid(rid, &next_tuple_rid)) {
+      break;
+    }
+    rid = next_tuple_rid;
+  }
+  cur_page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+  // move on from the last tuple read, to the next page if it was the last one of this page
+  tuple_->rid_ = rid;
+  ++(*this);
+}
+
 TableIterator TableIterator::operator++(int) {
   TableIterator clone(*this);
   ++(*this);
@@ -11,9 +11,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager.h"
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "gtest/gtest.h"
 
 namespace bustub {
@@ -140,4 +143,322 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+void ConcurrentHitAndEvict(ReplacerType replacer_type) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 32;
+  const int num_threads = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, nullptr, replacer_type);
+
+  std::vector<page_id_t> page_ids(num_pages);
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = page_ids[i];
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: lock-free hits race with evictions, a pinned page must always hold the requested content.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 rng(tid);
+      for (int i = 0; i < 5000; ++i) {
+        // Mostly hit a few hot pages, sometimes miss to force evictions.
+        page_id_t page_id = page_ids[rng() % 4 == 0 ? rng() % num_pages : rng() % 4];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        EXPECT_EQ(page_id, *reinterpret_cast<page_id_t *>(page->GetData()));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: every frame can be reclaimed afterwards, i.e. no pin was leaked.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DeletePageTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(i, page_id_temp);
+  }
+
+  // Scenario: a pinned page cannot be deleted and keeps its page id.
+  EXPECT_EQ(false, bpm->DeletePage(1));
+  EXPECT_EQ(true, disk_manager->IsAllocated(1));
+
+  // Scenario: once unpinned it is deleted, and its page id is handed out to the next new page.
+  EXPECT_EQ(true, bpm->UnpinPage(1, true));
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  EXPECT_EQ(false, disk_manager->IsAllocated(1));
+  auto *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, page_id_temp);
+  EXPECT_EQ(0, page->GetData()[0]);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(3, page_id_temp);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentHitAndEvictTest) {
+  ConcurrentHitAndEvict(ReplacerType::LRU);
+  ConcurrentHitAndEvict(ReplacerType::CLOCK);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ScanRingTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 32;
+  const int num_hot_pages = 8;
+  const int num_scan_pages = 200;
+  const size_t ring_size = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_hot_pages + num_scan_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    snprintf(bpm->FetchPage(page_id_temp)->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  for (page_id_t hot = 0; hot < num_hot_pages; ++hot) {
+    ASSERT_NE(nullptr, bpm->FetchPage(hot));
+    EXPECT_EQ(true, bpm->UnpinPage(hot, false));
+  }
+
+  // Scenario: a scan through a ring reads every page, but only recycles the frames of its own ring.
+  BufferAccessStrategy strategy(ring_size);
+  char expected[PAGE_SIZE];
+  for (page_id_t scan = num_hot_pages; scan < num_hot_pages + num_scan_pages; ++scan) {
+    auto *page = bpm->FetchPageWithStrategy(scan, &strategy);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", scan);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(scan, false));
+  }
+
+  // Scenario: the hot pages survived the scan, fetching them does not touch the disk.
+  int reads_before = disk_manager->GetNumReads();
+  for (page_id_t hot = 0; hot < num_hot_pages; ++hot) {
+    ASSERT_NE(nullptr, bpm->FetchPage(hot));
+    EXPECT_EQ(true, bpm->UnpinPage(hot, false));
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+
+  // Scenario: the ring fills up to its size before any of its frames is recycled, so a scan with the default ring
+  // keeps its last SCAN_RING_SIZE pages resident, and only those.
+  BufferAccessStrategy default_strategy;
+  const page_id_t scan_end = num_hot_pages + num_scan_pages / 2;
+  for (page_id_t scan = num_hot_pages; scan < scan_end; ++scan) {
+    ASSERT_NE(nullptr, bpm->FetchPageWithStrategy(scan, &default_strategy));
+    EXPECT_EQ(true, bpm->UnpinPage(scan, false));
+  }
+  EXPECT_EQ(nullptr, bpm->PeekPage(scan_end - SCAN_RING_SIZE - 1));
+  reads_before = disk_manager->GetNumReads();
+  for (page_id_t scan = scan_end - SCAN_RING_SIZE; scan < scan_end; ++scan) {
+    ASSERT_NE(nullptr, bpm->FetchPage(scan));
+    EXPECT_EQ(true, bpm->UnpinPage(scan, false));
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundFlusherTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the flusher cleans every dirty frame the replacer would victimize.
+  bpm->RunBackgroundFlusher(1.0);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  bool all_clean = false;
+  while (!all_clean && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    all_clean = true;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      all_clean = all_clean && !bpm->GetPages()[i].IsDirty();
+    }
+  }
+  bpm->StopBackgroundFlusher();
+  EXPECT_EQ(true, all_clean);
+
+  // Scenario: misses now evict clean victims and do not write anything.
+  int writes_before = disk_manager->GetNumWrites();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(writes_before, disk_manager->GetNumWrites());
+
+  // Scenario: the pages written by the flusher can be read back.
+  char expected[PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 32;
+  const int num_pages = 16;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    page_ids.push_back(page_id_temp);
+  }
+  bpm->FlushAllPages();
+  delete bpm;
+
+  // Scenario: prefetching consecutive pages into a cold buffer pool reads them all with a single disk read.
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  int reads_before = disk_manager->GetNumReads();
+  bpm->PrefetchPages(page_ids);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (disk_manager->GetNumReads() == reads_before && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(reads_before + 1, disk_manager->GetNumReads());
+
+  // Scenario: the prefetched pages are hits.
+  char expected[PAGE_SIZE];
+  for (page_id_t page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(reads_before + 1, disk_manager->GetNumReads());
+
+  // Scenario: page ids that were never allocated are not read.
+  bpm->PrefetchPages({num_pages + 100});
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(reads_before + 1, disk_manager->GetNumReads());
+
+  // Scenario: fetches of pages that are being prefetched wait for the prefetch, and find its frames.
+  delete bpm;
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  bpm->PrefetchPages(page_ids);
+  for (page_id_t page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(page, bpm->PeekPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DirectIOTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManager(db_name, DiskIOBackend::PREAD, true);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  // Scenario: every frame is aligned, so pages can be read and written with O_DIRECT without a bounce buffer.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(bpm->GetPages()[i].GetData()) % DIRECT_IO_ALIGNMENT);
+  }
+
+  // Scenario: pages evicted through O_DIRECT writes are read back intact.
+  page_id_t page_id_temp;
+  for (int i = 0; i < 16; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  char expected[PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < 16; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <cstdio>
 #include <thread>  // NOLINT
 #include <vector>
@@ -19,7 +20,7 @@
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +60,48 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, ConcurrencyTest) {
+  const int num_threads = 4;
+  const int frames_per_thread = 64;
+  ClockReplacer clock_replacer(num_threads * frames_per_thread);
+
+  // Scenario: every thread pins and unpins its own frames concurrently.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&clock_replacer, tid]() {
+      for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < frames_per_thread; ++i) {
+          clock_replacer.Unpin(tid * frames_per_thread + i);
+        }
+        for (int i = 0; i < frames_per_thread; i += 2) {
+          clock_replacer.Pin(tid * frames_per_thread + i);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * frames_per_thread / 2, clock_replacer.Size());
+
+  // Scenario: concurrent victims hand out every unpinned frame exactly once.
+  std::vector<std::atomic<int>> victimized(num_threads * frames_per_thread);
+  threads.clear();
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&]() {
+      frame_id_t frame_id;
+      while (clock_replacer.Victim(&frame_id)) {
+        victimized[frame_id]++;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+  for (int i = 0; i < num_threads * frames_per_thread; ++i) {
+    EXPECT_EQ(i % 2, victimized[i]);
+  }
+}
+
 }  // namespace bustub
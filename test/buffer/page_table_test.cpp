@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(4);
+  frame_id_t frame_id;
+
+  // Scenario: an empty table finds nothing.
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+
+  // Scenario: insert a few pages and look them up.
+  page_table.Insert(0, 3);
+  page_table.Insert(7, 2);
+  page_table.Insert(12, 1);
+  EXPECT_TRUE(page_table.Find(7, &frame_id));
+  EXPECT_EQ(2, frame_id);
+  EXPECT_TRUE(page_table.Find(0, &frame_id));
+  EXPECT_EQ(3, frame_id);
+
+  // Scenario: removed pages are gone, the others stay.
+  EXPECT_TRUE(page_table.Remove(0));
+  EXPECT_FALSE(page_table.Remove(0));
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+  EXPECT_TRUE(page_table.Find(12, &frame_id));
+  EXPECT_EQ(1, frame_id);
+}
+
+TEST(PageTableTest, ChurnTest) {
+  // Scenario: keep the table full while replacing pages, as the buffer pool does under eviction.
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::vector<page_id_t> resident;
+  std::mt19937 rng(15445);
+
+  page_id_t next_page_id = 0;
+  for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames); ++i) {
+    page_table.Insert(next_page_id, i);
+    expected[next_page_id] = i;
+    resident.push_back(next_page_id++);
+  }
+  for (int round = 0; round < 10000; ++round) {
+    size_t victim = rng() % resident.size();
+    page_id_t old_page_id = resident[victim];
+    frame_id_t frame_id = expected[old_page_id];
+    ASSERT_TRUE(page_table.Remove(old_page_id));
+    expected.erase(old_page_id);
+
+    page_id_t new_page_id = (rng() % 2 == 0) ? next_page_id++ : static_cast<page_id_t>(rng() % next_page_id);
+    if (expected.count(new_page_id) != 0) {
+      new_page_id = next_page_id++;
+    }
+    page_table.Insert(new_page_id, frame_id);
+    expected[new_page_id] = frame_id;
+    resident[victim] = new_page_id;
+  }
+
+  for (page_id_t page_id = 0; page_id < next_page_id; ++page_id) {
+    frame_id_t frame_id;
+    auto iter = expected.find(page_id);
+    ASSERT_EQ(iter != expected.end(), page_table.Find(page_id, &frame_id));
+    if (iter != expected.end()) {
+      EXPECT_EQ(iter->second, frame_id);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 5;
+  const size_t buffer_pool_size = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(num_instances * buffer_pool_size, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: Page ids are spread round robin over the instances, so we can fill up every instance.
+  for (size_t i = 1; i < num_instances * buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(INVALID_PAGE_ID, page_id_temp);
+
+  // Scenario: Unpinning page 0 only frees a frame in the instance owning page 0.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_EQ(true, bpm->FlushPage(0));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: Page 0 can be evicted by another page of its own instance, and read back from disk afterwards.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_instances * buffer_pool_size); ++page_id) {
+    if (page_id != 0) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+  page_id_t page_id_victim = 0;
+  while (page_id_victim % num_instances != 0 || page_id_victim == 0) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_victim));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_victim, false));
+  }
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const std::string db_name = "test.db";
+  const int num_threads = 8;
+  const int num_pages = 64;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 8, disk_manager);
+
+  std::vector<page_id_t> page_ids(num_pages);
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = page_ids[i];
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: concurrent fetches that do not fit in the pool always see the data written to each page.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 rng(tid);
+      for (int i = 0; i < 1000; ++i) {
+        page_id_t page_id = page_ids[rng() % num_pages];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(page_id, *reinterpret_cast<page_id_t *>(page->GetData()));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/**
+ * Runs num_threads threads that fetch and unpin random resident pages, and returns the throughput in ops/sec.
+ */
+double RunFetchUnpinBenchmark(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids, int num_threads,
+                              int ops_per_thread) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 rng(tid);
+      for (int i = 0; i < ops_per_thread; ++i) {
+        page_id_t page_id = page_ids[rng() % page_ids.size()];
+        bpm->FetchPage(page_id);
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(num_threads) * ops_per_thread / elapsed.count();
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ThroughputBenchmark) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 16;
+  const size_t pool_size = 512;
+  const int num_pages = 256;
+  const int total_ops = 1 << 16;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *single_bpm = new BufferPoolManager(pool_size * num_instances, disk_manager);
+  auto *parallel_bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  // Both pools cache the same pages, so the benchmark only measures hit path contention.
+  std::vector<page_id_t> page_ids(num_pages);
+  for (int i = 0; i < num_pages; ++i) {
+    ASSERT_NE(nullptr, parallel_bpm->NewPage(&page_ids[i]));
+    parallel_bpm->UnpinPage(page_ids[i], true);
+    ASSERT_NE(nullptr, single_bpm->FetchPage(page_ids[i]));
+    single_bpm->UnpinPage(page_ids[i], false);
+  }
+
+  for (int num_threads = 1; num_threads <= 32; num_threads *= 2) {
+    double single = RunFetchUnpinBenchmark(single_bpm, page_ids, num_threads, total_ops / num_threads);
+    double parallel = RunFetchUnpinBenchmark(parallel_bpm, page_ids, num_threads, total_ops / num_threads);
+    std::cout << "threads: " << num_threads << " BufferPoolManager: " << static_cast<int64_t>(single)
+              << " ops/sec, ParallelBufferPoolManager: " << static_cast<int64_t>(parallel) << " ops/sec" << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete single_bpm;
+  delete parallel_bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
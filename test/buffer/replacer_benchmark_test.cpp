@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark_test.cpp
+//
+// Identification: test/buffer/replacer_benchmark_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * Replays the calls the buffer pool makes: every op unpins a random frame, pins another one, and every 8th op asks for
+ * a victim. Frames are partitioned between the threads so that the replacer sees a valid call sequence.
+ * @return the throughput in ops/sec
+ */
+double RunReplacerBenchmark(Replacer *replacer, size_t num_frames, int num_threads, int ops_per_thread) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([=]() {
+      std::mt19937 rng(tid);
+      size_t frames_per_thread = num_frames / num_threads;
+      auto base = static_cast<frame_id_t>(tid * frames_per_thread);
+      for (int i = 0; i < ops_per_thread; ++i) {
+        replacer->Unpin(base + static_cast<frame_id_t>(rng() % frames_per_thread));
+        replacer->Pin(base + static_cast<frame_id_t>(rng() % frames_per_thread));
+        if (i % 8 == 0) {
+          frame_id_t victim;
+          replacer->Victim(&victim);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(num_threads) * ops_per_thread / elapsed.count();
+}
+
+// NOLINTNEXTLINE
+TEST(ReplacerBenchmarkTest, OpsPerSecond) {
+  const size_t num_frames = 4096;
+  const int total_ops = 1 << 18;
+
+  for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    std::unique_ptr<Replacer> lru_replacer = std::make_unique<LRUReplacer>(num_frames);
+    std::unique_ptr<Replacer> clock_replacer = std::make_unique<ClockReplacer>(num_frames);
+    std::unique_ptr<Replacer> lru_k_replacer = std::make_unique<LRUKReplacer>(num_frames);
+    double lru = RunReplacerBenchmark(lru_replacer.get(), num_frames, num_threads, total_ops / num_threads);
+    double clock = RunReplacerBenchmark(clock_replacer.get(), num_frames, num_threads, total_ops / num_threads);
+    double lru_k = RunReplacerBenchmark(lru_k_replacer.get(), num_frames, num_threads, total_ops / num_threads);
+    std::cout << "threads: " << num_threads << " LRUReplacer: " << static_cast<int64_t>(lru)
+              << " ops/sec, ClockReplacer: " << static_cast<int64_t>(clock)
+              << " ops/sec, LRUKReplacer: " << static_cast<int64_t>(lru_k) << " ops/sec" << std::endl;
+  }
+}
+
+}  // namespace bustub
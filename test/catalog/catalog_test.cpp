@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -53,11 +54,25 @@ TEST(CatalogTest, CreateTableTest) {
   EXPECT_NE(nullptr, catalog->GetIndex(indexInfo->index_oid_));
   EXPECT_NE(nullptr, catalog->GetIndex(indexInfo->name_, indexInfo->table_name_));
 
-  // Notice that this test case doesn't check anything! :(
-  // It is up to you to extend it
+  // A hash index answers equality lookups.
+  IndexInfo *hashIndexInfo = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      nullptr, "potato_hash_index", table_name, schema, key_schema, key_attrs, static_cast<size_t>(4),
+      IndexType::HASH_INDEX);
+  EXPECT_EQ(IndexType::HASH_INDEX, hashIndexInfo->index_type_);
+  EXPECT_EQ(IndexType::BPLUS_TREE_INDEX, indexInfo->index_type_);
+  EXPECT_EQ(2, catalog->GetTableIndexes(table_name).size());
+  for (int32_t i = 0; i < 1000; i++) {
+    Tuple key({ValueFactory::GetIntegerValue(i % 100)}, &key_schema);
+    hashIndexInfo->index_->InsertEntry(key, RID(i, 0), nullptr);
+  }
+  std::vector<RID> rids;
+  hashIndexInfo->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(42)}, &key_schema), &rids, nullptr);
+  EXPECT_EQ(10, rids.size());
 
   delete catalog;
   delete bpm;
+  disk_manager->ShutDown();
+  remove("catalog_test.db");
   delete disk_manager;
 }
 
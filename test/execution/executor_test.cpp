@@ -10,24 +10,33 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "execution/plans/delete_plan.h"
+#include "execution/plans/hash_join_plan.h"
 #include "execution/plans/limit_plan.h"
+#include "execution/plans/sort_merge_join_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/top_n_plan.h"
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/table_generator.h"
 #include "concurrency/transaction_manager.h"
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
+#include "execution/executor_factory.h"
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/insert_executor.h"
+#include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/sort_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
@@ -36,6 +45,7 @@
 #include "gtest/gtest.h"
 #include "storage/b_plus_tree_test_util.h"  // NOLINT
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -435,6 +445,306 @@ TEST_F(ExecutorTest, SimpleNestedLoopJoinTest) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleHashJoinTest) {
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
+  // with test_1 on either side, so that the hash table is built on test_2 from the right and from the left
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col3 = MakeColumnValueExpression(schema, 0, "col3");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col3", col3}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  for (bool test_1_left : {true, false}) {
+    auto colA = MakeColumnValueExpression(*out_schema1, test_1_left ? 0 : 1, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, test_1_left ? 0 : 1, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, test_1_left ? 1 : 0, "col1");
+    auto col3 = MakeColumnValueExpression(*out_schema2, test_1_left ? 1 : 0, "col3");
+    auto out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col3", col3}});
+    std::vector<const AbstractPlanNode *> children{scan_plan1.get(), scan_plan2.get()};
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    if (!test_1_left) {
+      std::swap(children[0], children[1]);
+      std::swap(left_keys, right_keys);
+    }
+    HashJoinPlanNode join_plan(out_final, std::move(children), nullptr, std::move(left_keys), std::move(right_keys));
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 100);
+    std::unordered_set<int32_t> joined;
+    for (const auto &tuple : result_set) {
+      int32_t a = tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+      ASSERT_EQ(a, tuple.GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>());
+      joined.insert(a);
+    }
+    ASSERT_EQ(joined.size(), 100);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SpillingHashJoinTest) {
+  // SELECT l.colA, l.colB, r.colC FROM test_1 l JOIN test_1 r ON l.colA = r.colA
+  // with a budget of one page, so that both sides are partitioned on disk
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto colC = MakeColumnValueExpression(schema, 0, "colC");
+  auto colD = MakeColumnValueExpression(schema, 0, "colD");
+  auto *scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}, {"colD", colD}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto out_colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto out_colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto out_colC = MakeColumnValueExpression(*scan_schema, 1, "colC");
+  auto *out_final = MakeOutputSchema({{"colA", out_colA}, {"colB", out_colB}, {"colC", out_colC}});
+  {
+    auto left_key = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    auto right_key = MakeColumnValueExpression(*scan_schema, 1, "colA");
+    HashJoinPlanNode join_plan(out_final, {&scan_plan, &scan_plan}, nullptr, {left_key}, {right_key}, 1);
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), TEST1_SIZE);
+    std::unordered_set<int32_t> joined;
+    for (const auto &tuple : result_set) {
+      joined.insert(tuple.GetValue(out_final, 0).GetAs<int32_t>());
+    }
+    ASSERT_EQ(joined.size(), TEST1_SIZE);
+  }
+
+  // SELECT l.colA, l.colB, r.colC FROM test_1 l JOIN test_1 r ON 0 = 0 WHERE l.colA < 250 AND r.colA < 250
+  // every tuple has the same key, so the partitions are split again until the depth runs out, then joined anyway
+  {
+    auto *const250 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(250));
+    auto *predicate = MakeComparisonExpression(colA, const250, ComparisonType::LessThan);
+    SeqScanPlanNode filtered_plan{scan_schema, predicate, table_info->oid_};
+    auto *const0 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(0));
+    HashJoinPlanNode join_plan(out_final, {&filtered_plan, &filtered_plan}, nullptr, {const0}, {const0}, 1);
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 250 * 250);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SortTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB ASC, colA DESC
+  // sorted in memory, then with a budget of one page, so that runs are spilled and merged in several passes
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  auto out_colA = MakeColumnValueExpression(*out_schema, 0, "colA");
+  auto out_colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys{{OrderByType::ASC, out_colB},
+                                                                            {OrderByType::DESC, out_colA}};
+  for (size_t memory_pages : {static_cast<size_t>(EXTERNAL_SORT_BUFFER_PAGES), static_cast<size_t>(1)}) {
+    SortPlanNode sort_plan{out_schema, &scan_plan, order_bys, memory_pages};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    executor->Init();
+    std::vector<Tuple> result_set;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      result_set.push_back(tuple);
+    }
+    ASSERT_EQ(result_set.size(), TEST1_SIZE);
+    for (size_t i = 1; i < result_set.size(); i++) {
+      int32_t prev_a = result_set[i - 1].GetValue(out_schema, 0).GetAs<int32_t>();
+      int32_t prev_b = result_set[i - 1].GetValue(out_schema, 1).GetAs<int32_t>();
+      int32_t a = result_set[i].GetValue(out_schema, 0).GetAs<int32_t>();
+      int32_t b = result_set[i].GetValue(out_schema, 1).GetAs<int32_t>();
+      ASSERT_TRUE(prev_b < b || (prev_b == b && prev_a > a));
+    }
+    size_t num_spilled_runs = dynamic_cast<SortExecutor *>(executor.get())->GetNumSpilledRuns();
+    if (memory_pages == 1) {
+      // more runs than the fan-in of two, so that some of them are merged into longer runs first
+      ASSERT_GT(num_spilled_runs, 3);
+    } else {
+      ASSERT_EQ(num_spilled_runs, 0);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, TopNTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB DESC, colA ASC LIMIT limit OFFSET offset
+  // compared with the same slice of the sorted table
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  auto out_colA = MakeColumnValueExpression(*out_schema, 0, "colA");
+  auto out_colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys{{OrderByType::DESC, out_colB},
+                                                                            {OrderByType::ASC, out_colA}};
+  SortPlanNode sort_plan{out_schema, &scan_plan, order_bys};
+  std::vector<Tuple> sorted;
+  GetExecutionEngine()->Execute(&sort_plan, &sorted, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(sorted.size(), TEST1_SIZE);
+
+  for (auto limit_offset : std::vector<std::pair<size_t, size_t>>{{10, 0}, {10, 5}, {0, 5}, {50, TEST1_SIZE - 20}}) {
+    TopNPlanNode top_n_plan{out_schema, &scan_plan, order_bys, limit_offset.first, limit_offset.second};
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&top_n_plan, &result_set, GetTxn(), GetExecutorContext());
+    size_t expected_size = std::min(limit_offset.first, TEST1_SIZE - limit_offset.second);
+    ASSERT_EQ(result_set.size(), expected_size);
+    for (size_t i = 0; i < result_set.size(); i++) {
+      const Tuple &expected = sorted[limit_offset.second + i];
+      ASSERT_EQ(result_set[i].GetValue(out_schema, 0).GetAs<int32_t>(),
+                expected.GetValue(out_schema, 0).GetAs<int32_t>());
+      ASSERT_EQ(result_set[i].GetValue(out_schema, 1).GetAs<int32_t>(),
+                expected.GetValue(out_schema, 1).GetAs<int32_t>());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SortMergeJoinTest) {
+  auto table_info1 = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema1 = table_info1->schema_;
+  auto colA = MakeColumnValueExpression(schema1, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema1, 0, "colB");
+  auto *out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan1{out_schema1, nullptr, table_info1->oid_};
+  auto table_info2 = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+  auto &schema2 = table_info2->schema_;
+  auto col1 = MakeColumnValueExpression(schema2, 0, "col1");
+  auto col3 = MakeColumnValueExpression(schema2, 0, "col3");
+  auto *out_schema2 = MakeOutputSchema({{"col1", col1}, {"col3", col3}});
+  SeqScanPlanNode scan_plan2{out_schema2, nullptr, table_info2->oid_};
+
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
+  {
+    auto out_colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto out_colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto out_col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto out_col3 = MakeColumnValueExpression(*out_schema2, 1, "col3");
+    auto *out_final =
+        MakeOutputSchema({{"colA", out_colA}, {"colB", out_colB}, {"col1", out_col1}, {"col3", out_col3}});
+    SortMergeJoinPlanNode join_plan(out_final, {&scan_plan1, &scan_plan2}, nullptr, {out_colA}, {out_col1});
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 100);
+    for (size_t i = 0; i < result_set.size(); i++) {
+      int32_t a = result_set[i].GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+      ASSERT_EQ(a, i);
+      ASSERT_EQ(a, result_set[i].GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>());
+    }
+  }
+
+  // SELECT l.colA, r.colA FROM test_1 l JOIN test_1 r ON l.colA = r.colA
+  // both sides are declared sorted, since test_1 is scanned in the order of its serial colA
+  {
+    auto left_colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto right_colA = MakeColumnValueExpression(*out_schema1, 1, "colA");
+    auto *out_final = MakeOutputSchema({{"colA", left_colA}});
+    SortMergeJoinPlanNode join_plan(out_final, {&scan_plan1, &scan_plan1}, nullptr, {left_colA}, {right_colA}, true,
+                                    true);
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), TEST1_SIZE);
+  }
+
+  // SELECT l.colA, r.colA FROM test_1 l JOIN test_1 r ON l.colB = r.colB WHERE l.colA < r.colA
+  // every left tuple joins a group of the right tuples with the same colB
+  {
+    auto left_colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto left_colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto right_colA = MakeColumnValueExpression(*out_schema1, 1, "colA");
+    auto right_colB = MakeColumnValueExpression(*out_schema1, 1, "colB");
+    auto *predicate = MakeComparisonExpression(left_colA, right_colA, ComparisonType::LessThan);
+    auto *out_final = MakeOutputSchema({{"colB", left_colB}});
+    SortMergeJoinPlanNode join_plan(out_final, {&scan_plan1, &scan_plan1}, predicate, {left_colB}, {right_colB});
+
+    // the pairs of distinct tuples having the same colB, counted per colB
+    std::vector<Tuple> scanned;
+    GetExecutionEngine()->Execute(&scan_plan1, &scanned, GetTxn(), GetExecutorContext());
+    std::unordered_map<int32_t, size_t> group_sizes;
+    for (const auto &tuple : scanned) {
+      group_sizes[tuple.GetValue(out_schema1, 1).GetAs<int32_t>()]++;
+    }
+    size_t expected = 0;
+    for (const auto &group : group_sizes) {
+      expected += group.second * (group.second - 1) / 2;
+    }
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), expected);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleNestedIndexJoinTest) {
+  // SELECT outer.colA, outer.colB, inner.colB FROM test_1 outer JOIN test_1 inner ON outer.colA = inner.colA
+  // with an index on inner.colA, probed in batches of outer tuples
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {0}, 8);
+
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  const Schema *outer_schema;
+  {
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    outer_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(outer_schema, nullptr, table_info->oid_);
+  }
+  const Schema *inner_schema;
+  {
+    auto colA = MakeColumnValueExpression(schema, 1, "colA");
+    auto colB = MakeColumnValueExpression(schema, 1, "colB");
+    inner_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  }
+  std::unique_ptr<NestedIndexJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto outerA = MakeColumnValueExpression(*outer_schema, 0, "colA");
+    auto outerB = MakeColumnValueExpression(*outer_schema, 0, "colB");
+    auto innerA = MakeColumnValueExpression(*inner_schema, 1, "colA");
+    auto predicate = MakeComparisonExpression(outerA, innerA, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"colA", outerA}, {"colB", outerB}});
+    join_plan = std::make_unique<NestedIndexJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan.get()}, predicate, table_info->oid_, "index1",
+        outer_schema, inner_schema);
+  }
+
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(join_plan.get(), &result_set, GetTxn(), GetExecutorContext());
+  // every outer tuple finds itself, across several batches
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+  for (size_t i = 0; i < result_set.size(); i++) {
+    ASSERT_EQ(result_set[i].GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>(), i);
+  }
+  delete key_schema;
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
@@ -546,4 +856,109 @@ TEST_F(ExecutorTest, SimpleGroupByAggregation) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, BatchSeqScanLimitTest) {
+  // SELECT colA FROM test_1 LIMIT 100 OFFSET 450, pulled 64 tuples at a time
+
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  LimitPlanNode limit_plan{out_schema, &scan_plan, 100, 450};
+
+  // the scan fills every batch but the last one
+  auto scan = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+  ASSERT_TRUE(scan->SupportsBatch());
+  scan->Init();
+  TupleBatch batch(64);
+  uint32_t scanned = 0;
+  while (scan->NextBatch(&batch)) {
+    ASSERT_EQ(batch.Size(), std::min(64U, TEST1_SIZE - scanned));
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      ASSERT_EQ(batch.TupleAt(i).GetValue(out_schema, 0).GetAs<int32_t>(), scanned + i);
+    }
+    scanned += batch.Size();
+  }
+  ASSERT_EQ(scanned, TEST1_SIZE);
+
+  // the limit cuts its window out of the batches of the scan
+  auto limit = ExecutorFactory::CreateExecutor(GetExecutorContext(), &limit_plan);
+  ASSERT_TRUE(limit->SupportsBatch());
+  limit->Init();
+  std::vector<int32_t> limited;
+  while (limit->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      limited.push_back(batch.TupleAt(i).GetValue(out_schema, 0).GetAs<int32_t>());
+    }
+  }
+  ASSERT_EQ(limited.size(), 100);
+  for (size_t i = 0; i < limited.size(); i++) {
+    ASSERT_EQ(limited[i], 450 + i);
+  }
+
+  // the execution engine gives the same tuples in batch mode
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&limit_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 100);
+  for (size_t i = 0; i < result_set.size(); i++) {
+    ASSERT_EQ(result_set[i].GetValue(out_schema, 0).GetAs<int32_t>(), 450 + i);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, BatchGroupByAggregationTest) {
+  // SELECT count(colA), colB, sum(colC) FROM test_1 Group By colB HAVING count(colA) > 90, pulled 3 groups at a time
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+  auto *scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+
+  const AbstractExpression *groupbyB = MakeAggregateValueExpression(true, 0);
+  const AbstractExpression *countA = MakeAggregateValueExpression(false, 0);
+  const AbstractExpression *sumC = MakeAggregateValueExpression(false, 1);
+  const AbstractExpression *having = MakeComparisonExpression(
+      countA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(90)), ComparisonType::GreaterThan);
+  auto *agg_schema = MakeOutputSchema({{"countA", countA}, {"colB", groupbyB}, {"sumC", sumC}});
+  AggregationPlanNode agg_plan{agg_schema,
+                               &scan_plan,
+                               having,
+                               {MakeColumnValueExpression(*scan_schema, 0, "colB")},
+                               {MakeColumnValueExpression(*scan_schema, 0, "colA"),
+                                MakeColumnValueExpression(*scan_schema, 0, "colC")},
+                               {AggregationType::CountAggregate, AggregationType::SumAggregate}};
+
+  // the groups pulled one at a time
+  auto agg = ExecutorFactory::CreateExecutor(GetExecutorContext(), &agg_plan);
+  agg->Init();
+  std::unordered_map<int32_t, std::pair<int32_t, int32_t>> expected;
+  Tuple tuple;
+  RID rid;
+  while (agg->Next(&tuple, &rid)) {
+    expected[tuple.GetValue(agg_schema, 1).GetAs<int32_t>()] = {tuple.GetValue(agg_schema, 0).GetAs<int32_t>(),
+                                                                 tuple.GetValue(agg_schema, 2).GetAs<int32_t>()};
+  }
+
+  // the batches hold the same groups, the HAVING clause drops the same ones
+  agg = ExecutorFactory::CreateExecutor(GetExecutorContext(), &agg_plan);
+  ASSERT_TRUE(agg->SupportsBatch());
+  agg->Init();
+  TupleBatch batch(3);
+  std::unordered_map<int32_t, std::pair<int32_t, int32_t>> batched;
+  while (agg->NextBatch(&batch)) {
+    ASSERT_LE(batch.Size(), 3);
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      const Tuple &group = batch.TupleAt(i);
+      ASSERT_GT(group.GetValue(agg_schema, 0).GetAs<int32_t>(), 90);
+      batched[group.GetValue(agg_schema, 1).GetAs<int32_t>()] = {group.GetValue(agg_schema, 0).GetAs<int32_t>(),
+                                                                  group.GetValue(agg_schema, 2).GetAs<int32_t>()};
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+  ASSERT_EQ(batched, expected);
+}
+
 }  // namespace bustub
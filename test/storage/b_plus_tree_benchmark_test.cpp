@@ -0,0 +1,89 @@
+/**
+ * b_plus_tree_benchmark_test.cpp
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+/**
+ * Random point lookups of keys in [0, num_keys).
+ * @return the throughput in lookups/sec
+ */
+double RunLookupBenchmark(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, int64_t num_keys,
+                          int num_lookups) {
+  std::mt19937 rng(0);
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_lookups; ++i) {
+    int64_t key = static_cast<int64_t>(rng() % num_keys);
+    index_key.SetFromInteger(key);
+    rids.clear();
+    tree->GetValue(index_key, &rids);
+    EXPECT_EQ(key, rids[0].GetSlotNum());
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return num_lookups / elapsed.count();
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBenchmarkTest, ComparatorLookupsPerSecond) {
+  const int64_t num_keys = 100000;
+  const int num_lookups = 1 << 18;
+
+  // the keys of a single integer column are compared as integers, other keys that fit normalized with memcmp
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  Schema *int_schema = ParseCreateStatement("a integer");
+  Schema *composite_schema = ParseCreateStatement("a integer,b integer");
+  EXPECT_EQ(KeyLayout::BIGINT, GenericComparator<8>(key_schema).GetLayout());
+  EXPECT_EQ(KeyLayout::INTEGER, GenericComparator<4>(int_schema).GetLayout());
+  EXPECT_EQ(KeyLayout::GENERIC, GenericComparator<4>(key_schema).GetLayout());
+  EXPECT_EQ(KeyLayout::NORMALIZED, GenericComparator<8>(composite_schema).GetLayout());
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(1000, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  GenericComparator<8> generic_comparator(key_schema, KeyLayout::GENERIC);
+  GenericComparator<8> specialized_comparator(key_schema);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> generic_tree("generic", bpm, generic_comparator);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> specialized_tree("specialized", bpm, specialized_comparator);
+  for (auto *tree : {&generic_tree, &specialized_tree}) {
+    int64_t key = 0;
+    tree->BulkLoad([&key, num_keys](std::pair<GenericKey<8>, RID> *item) {
+      if (key == num_keys) {
+        return false;
+      }
+      item->first.SetFromInteger(key);
+      item->second.Set(0, static_cast<uint32_t>(key));
+      key++;
+      return true;
+    });
+  }
+
+  double generic = RunLookupBenchmark(&generic_tree, num_keys, num_lookups);
+  double specialized = RunLookupBenchmark(&specialized_tree, num_keys, num_lookups);
+  std::cout << "keys: " << num_keys << " GenericComparator: " << static_cast<int64_t>(generic)
+            << " lookups/sec, specialized: " << static_cast<int64_t>(specialized) << " lookups/sec" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete int_schema;
+  delete composite_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
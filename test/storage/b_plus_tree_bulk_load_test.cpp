@@ -0,0 +1,138 @@
+/**
+ * b_plus_tree_bulk_load_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/external_sorter.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, ExternalSorterTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(10, disk_manager);
+
+  std::vector<int64_t> values(20000);
+  std::mt19937 gen(42);
+  for (auto &value : values) {
+    value = gen() % 5000;
+  }
+  auto less = [](int64_t a, int64_t b) { return a < b; };
+  using Sorter = ExternalSorter<int64_t, decltype(less)>;
+  {
+    // one page worth of records in memory and a pool of 10 frames: the runs take several merge passes
+    Sorter sorter(bpm, less, 1);
+    for (auto value : values) {
+      sorter.Add(value);
+    }
+    sorter.Sort();
+    EXPECT_GT(sorter.GetNumSpilledRuns(), values.size() / Sorter::RECORDS_PER_PAGE);
+
+    std::sort(values.begin(), values.end());
+    int64_t value;
+    for (auto expected : values) {
+      ASSERT_TRUE(sorter.Next(&value));
+      EXPECT_EQ(expected, value);
+    }
+    EXPECT_FALSE(sorter.Next(&value));
+  }
+  // every temporary page was given back
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  EXPECT_EQ(0, page_id);
+  bpm->UnpinPage(page_id, false);
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, BulkLoadTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  GenericKey<8> index_key;
+  RID rid;
+  std::vector<RID> rids;
+  Transaction transaction(0);
+  std::mt19937 gen(7);
+
+  // every tree height, and every shape of the last pages of each level
+  for (int64_t num_keys = 0; num_keys < 300; num_keys++) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 5, 4);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+
+    // every key twice, in random order
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= num_keys; key++) {
+      keys.push_back(key);
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), gen);
+    size_t next = 0;
+    tree.BulkLoad(
+        [&](std::pair<GenericKey<8>, RID> *item) {
+          if (next == keys.size()) {
+            return false;
+          }
+          item->first.SetFromInteger(keys[next]);
+          item->second.Set(static_cast<int32_t>(keys[next]), static_cast<int32_t>(keys[next]));
+          next++;
+          return true;
+        },
+        0.7, 1);
+    EXPECT_EQ(num_keys == 0, tree.IsEmpty());
+
+    // one pair per key, and the leaves are chained
+    int64_t size = 0;
+    for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+      size++;
+    }
+    EXPECT_EQ(num_keys, size);
+    for (int64_t key = 1; key <= num_keys; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.GetValue(index_key, &rids));
+      EXPECT_EQ(key, rids[0].GetSlotNum());
+    }
+
+    // the tree takes inserts and removes, which rely on the parent links and the min sizes
+    index_key.SetFromInteger(num_keys + 1);
+    rid.Set(0, static_cast<int32_t>(num_keys + 1));
+    EXPECT_TRUE(tree.Insert(index_key, rid, &transaction));
+    std::vector<int64_t> remove_keys(keys.begin(), keys.begin() + num_keys);
+    std::sort(remove_keys.begin(), remove_keys.end());
+    remove_keys.erase(std::unique(remove_keys.begin(), remove_keys.end()), remove_keys.end());
+    for (auto key : remove_keys) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, &transaction);
+    }
+    for (int64_t key = 1; key <= num_keys + 1; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      bool removed = std::binary_search(remove_keys.begin(), remove_keys.end(), key);
+      EXPECT_EQ(!removed, tree.GetValue(index_key, &rids));
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+  delete key_schema;
+}
+
+}  // namespace bustub
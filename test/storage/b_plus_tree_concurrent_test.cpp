@@ -2,9 +2,12 @@
  * b_plus_tree_test.cpp
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
+#include <random>
 #include <thread>                   // NOLINT
 #include "b_plus_tree_test_util.h"  // NOLINT
 
@@ -330,4 +333,342 @@ TEST(BPlusTreeConcurrentTest, MixTest) {
   remove("test.log");
 }
 
+// helper function to look up keys that must always be found
+void LookupHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, const std::vector<int64_t> &keys,
+                  int rounds, std::atomic<int> *missing, __attribute__((unused)) uint64_t thread_itr = 0) {
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (int round = 0; round < rounds; ++round) {
+    for (auto key : keys) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      if (!tree->GetValue(index_key, &rids) || rids[0].GetSlotNum() != (key & 0xFFFFFFFF)) {
+        (*missing)++;
+      }
+    }
+  }
+}
+
+TEST(BPlusTreeConcurrentTest, OptimisticReadTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree, small pages so that writers split and merge pages all the time
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // the odd keys stay in the tree, the even keys come and go
+  std::vector<int64_t> stable_keys;
+  std::vector<int64_t> churn_keys;
+  for (int64_t key = 1; key < 400; key++) {
+    (key % 2 == 1 ? stable_keys : churn_keys).push_back(key);
+  }
+  InsertHelper(&tree, stable_keys);
+
+  // Scenario: readers that take no latch always find the stable keys while writers restructure the tree.
+  std::atomic<int> missing{0};
+  std::thread reader1(LookupHelper, &tree, stable_keys, 20, &missing, 0);
+  std::thread reader2(LookupHelper, &tree, stable_keys, 20, &missing, 1);
+  for (int round = 0; round < 10; ++round) {
+    LaunchParallelTest(2, InsertHelperSplit, &tree, churn_keys, 2);
+    LaunchParallelTest(2, DeleteHelperSplit, &tree, churn_keys, 2);
+  }
+  reader1.join();
+  reader2.join();
+  EXPECT_EQ(0, missing);
+
+  // Scenario: the tree is still intact afterwards.
+  int64_t size = 0;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(stable_keys[size], (*iterator).second.GetSlotNum());
+    size = size + 1;
+  }
+  EXPECT_EQ(size, stable_keys.size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+// helper function to look up batches of keys, the odd ones must always be found and the ones past 1000 never
+void BatchLookupHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, const std::vector<int64_t> &keys,
+                       int rounds, std::atomic<int> *wrong, __attribute__((unused)) uint64_t thread_itr = 0) {
+  std::vector<GenericKey<8>> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromInteger(keys[i]);
+  }
+  std::vector<std::vector<RID>> results;
+  for (int round = 0; round < rounds; ++round) {
+    tree->GetValues(index_keys, &results);
+    for (size_t i = 0; i < keys.size(); i++) {
+      bool found = !results[i].empty();
+      if ((keys[i] % 2 == 1 && keys[i] < 1000 && !found) || (keys[i] > 1000 && found) ||
+          (found && results[i][0].GetSlotNum() != keys[i])) {
+        (*wrong)++;
+      }
+    }
+  }
+}
+
+TEST(BPlusTreeConcurrentTest, BatchLookupTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree, small pages so that writers split and merge pages all the time
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // the odd keys stay in the tree, the even keys come and go
+  std::vector<int64_t> stable_keys;
+  std::vector<int64_t> churn_keys;
+  for (int64_t key = 1; key < 400; key++) {
+    (key % 2 == 1 ? stable_keys : churn_keys).push_back(key);
+  }
+  InsertHelper(&tree, stable_keys);
+
+  // Scenario: a batch in random order, with duplicates and missing keys, gets one result per key in its order.
+  std::vector<int64_t> batch;
+  for (int64_t key = 1; key < 400; key++) {
+    batch.push_back(key);
+    batch.push_back(key + 1000);
+  }
+  batch.push_back(7);
+  std::shuffle(batch.begin(), batch.end(), std::mt19937(0));
+  std::vector<GenericKey<8>> index_keys(batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    index_keys[i].SetFromInteger(batch[i]);
+  }
+  std::vector<std::vector<RID>> results;
+  EXPECT_EQ(stable_keys.size() + 1, tree.GetValues(index_keys, &results));
+  ASSERT_EQ(batch.size(), results.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    bool stable = batch[i] < 1000 && batch[i] % 2 == 1;
+    ASSERT_EQ(stable ? 1 : 0, results[i].size());
+    if (stable) {
+      EXPECT_EQ(batch[i], results[i][0].GetSlotNum());
+    }
+  }
+
+  // Scenario: batches are looked up without latches while writers restructure the tree.
+  std::atomic<int> wrong{0};
+  std::thread reader1(BatchLookupHelper, &tree, batch, 20, &wrong, 0);
+  std::thread reader2(BatchLookupHelper, &tree, batch, 20, &wrong, 1);
+  for (int round = 0; round < 10; ++round) {
+    LaunchParallelTest(2, InsertHelperSplit, &tree, churn_keys, 2);
+    LaunchParallelTest(2, DeleteHelperSplit, &tree, churn_keys, 2);
+  }
+  reader1.join();
+  reader2.join();
+  EXPECT_EQ(0, wrong);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, OptimisticWriteTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 8);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  std::vector<int64_t> keys;
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 1; key < 1000; key++) {
+    keys.push_back(key);
+    if (key % 3 == 0) {
+      remove_keys.push_back(key);
+    }
+  }
+
+  // Scenario: inserts and removes that fit in their leaf only write latch the leaf, the others retry pessimistically.
+  LaunchParallelTest(4, InsertHelperSplit, &tree, keys, 4);
+  LaunchParallelTest(4, DeleteHelperSplit, &tree, remove_keys, 4);
+
+  // Scenario: duplicate keys are still rejected on the optimistic path.
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(1);
+  Transaction transaction(0);
+  EXPECT_EQ(false, tree.Insert(index_key, RID(0, 1), &transaction));
+
+  int64_t expected_key = 1;
+  int64_t size = 0;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    if (expected_key % 3 == 0) {
+      expected_key++;
+    }
+    EXPECT_EQ(expected_key, (*iterator).second.GetSlotNum());
+    expected_key++;
+    size = size + 1;
+  }
+  EXPECT_EQ(size, keys.size() - remove_keys.size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+// helper function to scan a range, the odd keys in it must always be visited in order
+void RangeScanHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, int64_t low, int64_t high, int rounds,
+                     std::atomic<int> *wrong, __attribute__((unused)) uint64_t thread_itr = 0) {
+  GenericKey<8> low_key;
+  GenericKey<8> high_key;
+  low_key.SetFromInteger(low);
+  high_key.SetFromInteger(high);
+  for (int round = 0; round < rounds; ++round) {
+    int64_t expected_key = low % 2 == 1 ? low : low + 1;
+    int64_t last_key = low - 1;
+    for (auto iterator = tree->Begin(&low_key, &high_key); iterator != tree->end(); ++iterator) {
+      int64_t key = (*iterator).second.GetSlotNum();
+      if (key <= last_key || key > high || (key % 2 == 1 && key != expected_key)) {
+        (*wrong)++;
+      }
+      if (key % 2 == 1) {
+        expected_key = key + 2;
+      }
+      last_key = key;
+    }
+    if (expected_key <= high) {
+      (*wrong)++;
+    }
+  }
+}
+
+TEST(BPlusTreeConcurrentTest, RangeScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree, small pages so that scans cross many leaves and writers split and merge them all the time
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  GenericKey<8> low_key;
+  GenericKey<8> high_key;
+  low_key.SetFromInteger(1);
+  high_key.SetFromInteger(10);
+
+  // Scenario: every scan of an empty tree is empty.
+  EXPECT_TRUE(tree.Begin(&low_key, &high_key) == tree.end());
+  EXPECT_TRUE(tree.begin() == tree.end());
+
+  // the odd keys stay in the tree, the even keys come and go
+  std::vector<int64_t> stable_keys;
+  std::vector<int64_t> churn_keys;
+  for (int64_t key = 1; key < 400; key++) {
+    (key % 2 == 1 ? stable_keys : churn_keys).push_back(key);
+  }
+  InsertHelper(&tree, stable_keys);
+
+  // Scenario: the bounds are inclusive, whether or not they are keys of the tree, and either may be left out.
+  auto scan = [&](const GenericKey<8> *low, const GenericKey<8> *high) {
+    std::vector<int64_t> keys;
+    for (auto iterator = tree.Begin(low, high); !iterator.isEnd(); ++iterator) {
+      keys.push_back((*iterator).second.GetSlotNum());
+    }
+    return keys;
+  };
+  low_key.SetFromInteger(101);
+  high_key.SetFromInteger(111);
+  EXPECT_EQ(std::vector<int64_t>({101, 103, 105, 107, 109, 111}), scan(&low_key, &high_key));
+  low_key.SetFromInteger(100);
+  high_key.SetFromInteger(104);
+  EXPECT_EQ(std::vector<int64_t>({101, 103}), scan(&low_key, &high_key));
+  high_key.SetFromInteger(100);
+  EXPECT_EQ(std::vector<int64_t>(), scan(&low_key, &high_key));
+  high_key.SetFromInteger(6);
+  EXPECT_EQ(std::vector<int64_t>({1, 3, 5}), scan(nullptr, &high_key));
+  low_key.SetFromInteger(394);
+  EXPECT_EQ(std::vector<int64_t>({395, 397, 399}), scan(&low_key, nullptr));
+  low_key.SetFromInteger(400);
+  EXPECT_EQ(std::vector<int64_t>(), scan(&low_key, nullptr));
+  EXPECT_EQ(stable_keys, scan(nullptr, nullptr));
+
+  // Scenario: an iterator that is moved keeps its position, and the one moved from is at the end.
+  {
+    low_key.SetFromInteger(7);
+    auto iterator = tree.Begin(&low_key, nullptr);
+    auto moved = std::move(iterator);
+    EXPECT_TRUE(iterator.isEnd());  // NOLINT
+    EXPECT_EQ(7, (*moved).second.GetSlotNum());
+  }
+
+  // Scenario: the thread holding an open iterator removes the keys it visits, down to merging leaves, without
+  // blocking on the iterator, which goes on after the keys removed.
+  {
+    low_key.SetFromInteger(101);
+    high_key.SetFromInteger(141);
+    Transaction transaction(0);
+    std::vector<int64_t> visited;
+    for (auto iterator = tree.Begin(&low_key, &high_key); !iterator.isEnd(); ++iterator) {
+      int64_t key = (*iterator).second.GetSlotNum();
+      visited.push_back(key);
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, &transaction);
+    }
+    std::vector<int64_t> expected;
+    for (int64_t key = 101; key <= 141; key += 2) {
+      expected.push_back(key);
+    }
+    EXPECT_EQ(expected, visited);
+    EXPECT_EQ(std::vector<int64_t>(), scan(&low_key, &high_key));
+    InsertHelper(&tree, expected);
+    EXPECT_EQ(stable_keys, scan(nullptr, nullptr));
+  }
+
+  // Scenario: scans go from leaf to leaf while writers split and merge the leaves around them.
+  std::atomic<int> wrong{0};
+  std::thread scanner1(RangeScanHelper, &tree, 1, 399, 20, &wrong, 0);
+  std::thread scanner2(RangeScanHelper, &tree, 100, 250, 40, &wrong, 1);
+  for (int round = 0; round < 10; ++round) {
+    LaunchParallelTest(2, InsertHelperSplit, &tree, churn_keys, 2);
+    LaunchParallelTest(2, DeleteHelperSplit, &tree, churn_keys, 2);
+  }
+  scanner1.join();
+  scanner2.join();
+  EXPECT_EQ(0, wrong);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
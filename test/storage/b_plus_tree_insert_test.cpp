@@ -4,11 +4,15 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -780,4 +784,179 @@ TEST(BPlusTreeTests, InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, NormalizedKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a integer,b varchar(6),c double");
+  GenericComparator<64> generic_comparator(key_schema, KeyLayout::GENERIC);
+  GenericComparator<64> comparator(key_schema);
+  EXPECT_EQ(KeyLayout::NORMALIZED, comparator.GetLayout());
+  // the varchar alone takes 1 + 6 + 4 bytes, too much for an 8 byte key
+  EXPECT_EQ(KeyLayout::GENERIC, GenericComparator<8>(key_schema).GetLayout());
+
+  // few distinct values per column, so that the keys often tie on their first columns
+  std::mt19937 gen(3);
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 200; i++) {
+    std::string str(gen() % 7, 'a');
+    for (auto &c : str) {
+      c = static_cast<char>('a' + gen() % 2);
+    }
+    std::vector<Value> values{ValueFactory::GetIntegerValue(static_cast<int32_t>(gen() % 5) - 2),
+                              ValueFactory::GetVarcharValue(str),
+                              ValueFactory::GetDecimalValue((static_cast<double>(gen() % 9) - 4) / 2)};
+    tuples.emplace_back(values, key_schema);
+  }
+
+  // memcmp of the normalized keys orders them like the values of their columns
+  std::vector<GenericKey<64>> keys(tuples.size());
+  std::vector<GenericKey<64>> normalized_keys(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    keys[i].SetFromKey(tuples[i]);
+    normalized_keys[i].SetFromNormalizedKey(tuples[i], key_schema);
+  }
+  auto sign = [](int cmp) { return (cmp > 0) - (cmp < 0); };
+  for (size_t i = 0; i < tuples.size(); i++) {
+    for (size_t j = 0; j < tuples.size(); j++) {
+      ASSERT_EQ(sign(generic_comparator(keys[i], keys[j])), sign(comparator(normalized_keys[i], normalized_keys[j])))
+          << tuples[i].ToString(key_schema) << " vs " << tuples[j].ToString(key_schema);
+    }
+  }
+
+  delete key_schema;
+}
+TEST(BPlusTreeTests, KeySearchTest) {
+  Schema *bigint_schema = ParseCreateStatement("a bigint");
+  Schema *int_schema = ParseCreateStatement("a integer");
+  std::mt19937 gen(5);
+
+  // every layout finds the same bounds as std::lower_bound and std::upper_bound, across the window and binary search
+  for (auto *key_schema : {bigint_schema, int_schema}) {
+    for (auto layout : {KeyLayout::GENERIC, GenericComparator<8>::LayoutOf(key_schema)}) {
+      GenericComparator<8> comparator(key_schema, layout);
+      for (int n = 0; n < 80; n++) {
+        std::vector<int32_t> values(n);
+        for (auto &value : values) {
+          value = static_cast<int32_t>(gen() % 64) - 32;
+        }
+        std::sort(values.begin(), values.end());
+        std::vector<std::pair<GenericKey<8>, RID>> array(n);
+        for (int i = 0; i < n; i++) {
+          std::vector<Value> key_values{key_schema == bigint_schema ? ValueFactory::GetBigIntValue(values[i])
+                                                                    : ValueFactory::GetIntegerValue(values[i])};
+          array[i].first.SetFromKey(Tuple(key_values, key_schema));
+        }
+        for (int32_t needle = -34; needle < 34; needle++) {
+          std::vector<Value> key_values{key_schema == bigint_schema ? ValueFactory::GetBigIntValue(needle)
+                                                                    : ValueFactory::GetIntegerValue(needle)};
+          GenericKey<8> key;
+          key.SetFromKey(Tuple(key_values, key_schema));
+          ASSERT_EQ(std::lower_bound(values.begin(), values.end(), needle) - values.begin(),
+                    comparator.LowerBound(array.data(), 0, n, key));
+          ASSERT_EQ(std::upper_bound(values.begin(), values.end(), needle) - values.begin(),
+                    comparator.UpperBound(array.data(), 0, n, key));
+        }
+      }
+    }
+  }
+
+  delete bigint_schema;
+  delete int_schema;
+}
+
+TEST(BPlusTreeTests, DuplicateKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3, false);
+  Transaction *transaction = new Transaction(0);
+
+  // key k gets values (k, 0), ..., (k, k * k), the keys from 23 up get posting lists of several pages
+  const int64_t num_keys = 40;
+  GenericKey<8> index_key;
+  size_t total = 0;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    for (int64_t slot = 0; slot <= key * key; slot++) {
+      EXPECT_TRUE(tree.Insert(index_key, RID(static_cast<page_id_t>(key), static_cast<uint32_t>(slot)), transaction));
+      total++;
+    }
+    // the same pair is only there once
+    EXPECT_FALSE(tree.Insert(index_key, RID(static_cast<page_id_t>(key), 0), transaction));
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(static_cast<size_t>(key * key + 1), rids.size());
+    std::sort(rids.begin(), rids.end(), [](const RID &a, const RID &b) { return a.GetSlotNum() < b.GetSlotNum(); });
+    for (size_t slot = 0; slot < rids.size(); slot++) {
+      EXPECT_EQ(RID(static_cast<page_id_t>(key), slot), rids[slot]);
+    }
+  }
+  // the iterator visits every value of every key, in key order
+  size_t visited = 0;
+  int64_t last_key = 0;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    int64_t key = (*iterator).second.GetPageId();
+    EXPECT_LE(last_key, key);
+    last_key = key;
+    visited++;
+  }
+  EXPECT_EQ(total, visited);
+
+  // removing a pair leaves the other values of its key, down to the last one
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    for (int64_t slot = 0; slot < key * key; slot++) {
+      tree.Remove(index_key, RID(static_cast<page_id_t>(key), static_cast<uint32_t>(slot)), transaction);
+    }
+    tree.Remove(index_key, RID(static_cast<page_id_t>(key), static_cast<uint32_t>(key * key + 1)), transaction);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(RID(static_cast<page_id_t>(key), static_cast<uint32_t>(key * key)), rids[0]);
+    tree.Remove(index_key, rids[0], transaction);
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+  // removing a key removes all of its values
+  std::vector<GenericKey<8>> keys(num_keys);
+  for (int64_t key = 0; key < num_keys; key++) {
+    keys[key].SetFromInteger(key);
+  }
+  std::vector<std::vector<RID>> results;
+  EXPECT_EQ(static_cast<size_t>(num_keys / 2), tree.GetValues(keys, &results));
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    EXPECT_EQ(static_cast<size_t>(key * key + 1), results[key].size());
+    tree.Remove(keys[key], transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // a bulk load keeps the duplicates too
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> loaded_tree("bar_pk", bpm, comparator, 3, 3, false);
+  int64_t next = 0;
+  loaded_tree.BulkLoad([&next, num_keys](std::pair<GenericKey<8>, RID> *item) {
+    if (next == num_keys * num_keys) {
+      return false;
+    }
+    item->first.SetFromInteger(next % num_keys);
+    item->second = RID(static_cast<page_id_t>(next % num_keys), static_cast<uint32_t>(next / num_keys));
+    next++;
+    return true;
+  });
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(loaded_tree.GetValue(index_key, &rids));
+    EXPECT_EQ(static_cast<size_t>(num_keys), rids.size());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
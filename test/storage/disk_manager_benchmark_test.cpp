@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_benchmark_test.cpp
+//
+// Identification: test/storage/disk_manager_benchmark_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Random 4K reads at the given queue depth with pread: queue_depth threads each have one read in flight.
+ * @return the throughput in IOPS
+ */
+double RunPreadBenchmark(DiskManager *disk_manager, int num_pages, int queue_depth, int total_reads) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int tid = 0; tid < queue_depth; ++tid) {
+    threads.emplace_back([=]() {
+      std::mt19937 rng(tid);
+      char data[PAGE_SIZE];
+      for (int i = 0; i < total_reads / queue_depth; ++i) {
+        disk_manager->ReadPage(static_cast<page_id_t>(rng() % num_pages), data);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(total_reads / queue_depth * queue_depth) / elapsed.count();
+}
+
+/**
+ * Random 4K reads at the given queue depth with ReadPages: one thread submits batches of queue_depth reads.
+ * @return the throughput in IOPS
+ */
+double RunBatchBenchmark(DiskManager *disk_manager, int num_pages, int queue_depth, int total_reads) {
+  std::mt19937 rng(0);
+  std::vector<std::vector<char>> bufs(queue_depth, std::vector<char>(PAGE_SIZE));
+  std::vector<char *> page_data;
+  for (auto &buf : bufs) {
+    page_data.push_back(buf.data());
+  }
+  std::vector<page_id_t> page_ids(queue_depth);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < total_reads / queue_depth; ++i) {
+    for (auto &page_id : page_ids) {
+      page_id = static_cast<page_id_t>(rng() % num_pages);
+    }
+    disk_manager->ReadPages(page_ids, page_data);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(total_reads / queue_depth * queue_depth) / elapsed.count();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerBenchmarkTest, RandomReadIOPS) {
+  const std::string db_file("test.db");
+  const int num_pages = 4096;
+  const int total_reads = 1 << 14;
+
+  auto *disk_manager = new DiskManager(db_file);
+  char data[PAGE_SIZE] = {0};
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    snprintf(data, sizeof(data), "page %d", page_id);
+    disk_manager->WritePage(page_id, data);
+  }
+  auto *uring_disk_manager = new DiskManager(db_file, DiskIOBackend::IO_URING);
+  if (uring_disk_manager->GetBackend() != DiskIOBackend::IO_URING) {
+    std::cout << "io_uring is not available, batches fall back to preadv" << std::endl;
+  }
+
+  for (int queue_depth = 1; queue_depth <= 64; queue_depth *= 2) {
+    double pread = RunPreadBenchmark(disk_manager, num_pages, queue_depth, total_reads);
+    double batch = RunBatchBenchmark(uring_disk_manager, num_pages, queue_depth, total_reads);
+    std::cout << "queue depth: " << queue_depth << " pread: " << static_cast<int64_t>(pread)
+              << " IOPS, io_uring: " << static_cast<int64_t>(batch) << " IOPS" << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  uring_disk_manager->ShutDown();
+  remove(db_file.c_str());
+
+  delete uring_disk_manager;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -41,6 +44,150 @@ TEST(DiskManagerTest, ReadWritePageTest) {
   remove(db_file.c_str());
 }
 
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ReadPagesTest) {
+  std::string db_file("test.db");
+  for (auto backend : {DiskIOBackend::PREAD, DiskIOBackend::IO_URING}) {
+    auto dm = DiskManager(db_file, backend);
+    char data[PAGE_SIZE] = {0};
+    for (page_id_t page_id = 0; page_id < 8; ++page_id) {
+      snprintf(data, sizeof(data), "page %d", page_id);
+      dm.WritePage(page_id, data);
+    }
+
+    // Scenario: runs of consecutive pages are read with one I/O each, pages past the end of the file read as zeros.
+    std::vector<page_id_t> page_ids = {1, 2, 3, 6, 0, 8, 9};
+    std::vector<std::vector<char>> bufs(page_ids.size(), std::vector<char>(PAGE_SIZE, 'x'));
+    std::vector<char *> page_data;
+    for (auto &buf : bufs) {
+      page_data.push_back(buf.data());
+    }
+    int reads_before = dm.GetNumReads();
+    dm.ReadPages(page_ids, page_data);
+    EXPECT_EQ(reads_before + 4, dm.GetNumReads());
+    for (size_t i = 0; i < page_ids.size(); ++i) {
+      if (page_ids[i] < 8) {
+        snprintf(data, sizeof(data), "page %d", page_ids[i]);
+      } else {
+        std::memset(data, 0, sizeof(data));
+      }
+      EXPECT_EQ(std::memcmp(bufs[i].data(), data, PAGE_SIZE), 0);
+    }
+
+    dm.ShutDown();
+    remove(db_file.c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, DirectIOTest) {
+  alignas(PAGE_SIZE) char aligned_buf[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE + 1] = {0};
+  char data[PAGE_SIZE + 1] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, DiskIOBackend::PREAD, true);
+
+  // Scenario: unaligned buffers go through a bounce buffer, aligned ones are used as is.
+  std::strncpy(data + 1, "A test string.", PAGE_SIZE);
+  dm.WritePage(0, data + 1);
+  dm.ReadPage(0, buf + 1);
+  EXPECT_EQ(std::memcmp(buf + 1, data + 1, PAGE_SIZE), 0);
+  dm.ReadPage(0, aligned_buf);
+  EXPECT_EQ(std::memcmp(aligned_buf, data + 1, PAGE_SIZE), 0);
+
+  // Scenario: reading past the end of the file still reads zeros.
+  dm.ReadPage(3, aligned_buf);
+  std::memset(data, 0, sizeof(data));
+  EXPECT_EQ(std::memcmp(aligned_buf, data, PAGE_SIZE), 0);
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, AllocateDeallocateTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  for (page_id_t page_id = 0; page_id < 10; ++page_id) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+  }
+
+  // Scenario: freed pages are reused, lowest page id first, before the file grows.
+  dm.DeallocatePage(7);
+  dm.DeallocatePage(3);
+  dm.DeallocatePage(3);
+  EXPECT_FALSE(dm.IsAllocated(3));
+  EXPECT_TRUE(dm.IsAllocated(4));
+  EXPECT_EQ(3, dm.AllocatePage());
+  EXPECT_EQ(7, dm.AllocatePage());
+  EXPECT_EQ(10, dm.AllocatePage());
+  EXPECT_EQ(11, dm.GetNumPages());
+
+  // Scenario: an extent skips holes that are too small, and never spans two block groups.
+  dm.DeallocatePage(1);
+  dm.DeallocatePage(2);
+  EXPECT_EQ(11, dm.AllocateExtent(3));
+  EXPECT_EQ(1, dm.AllocateExtent(2));
+  EXPECT_EQ(14, dm.AllocateExtent(DiskManager::PAGES_PER_MAP - 16));
+  EXPECT_EQ(DiskManager::PAGES_PER_MAP, dm.AllocateExtent(4));
+  EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateExtent(DiskManager::PAGES_PER_MAP + 1));
+
+  // Scenario: pages of the second block group do not overwrite its map page.
+  char buf[PAGE_SIZE] = {0};
+  char data[PAGE_SIZE] = {0};
+  std::strncpy(data, "A test string.", sizeof(data));
+  dm.WritePage(DiskManager::PAGES_PER_MAP, data);
+  EXPECT_TRUE(dm.IsAllocated(DiskManager::PAGES_PER_MAP + 3));
+  dm.ReadPage(DiskManager::PAGES_PER_MAP, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, FreeSpaceMapPersistenceTest) {
+  char buf[PAGE_SIZE] = {0};
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  {
+    auto dm = DiskManager(db_file);
+    for (page_id_t page_id = 0; page_id < 5; ++page_id) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+    }
+    dm.WritePage(4, data);
+    dm.DeallocatePage(2);
+    dm.ShutDown();
+  }
+
+  // Scenario: the allocation state and the page ids handed out survive a restart.
+  auto dm = DiskManager(db_file);
+  EXPECT_EQ(5, dm.GetNumPages());
+  EXPECT_TRUE(dm.IsAllocated(1));
+  EXPECT_FALSE(dm.IsAllocated(2));
+  dm.ReadPage(4, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  EXPECT_EQ(2, dm.AllocatePage());
+  EXPECT_EQ(5, dm.AllocatePage());
+
+  // Scenario: allocations only reach the file when the map is flushed.
+  {
+    auto reader = DiskManager(db_file);
+    EXPECT_FALSE(reader.IsAllocated(5));
+    reader.ShutDown();
+  }
+  EXPECT_TRUE(dm.FlushFreeSpaceMap());
+  {
+    auto reader = DiskManager(db_file);
+    EXPECT_TRUE(reader.IsAllocated(5));
+    reader.ShutDown();
+  }
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
 TEST(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
   char data[16] = {0};
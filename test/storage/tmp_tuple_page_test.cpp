@@ -19,11 +19,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
+TEST(TmpTuplePageTest, BasicTest) {
   TmpTuplePage page{};
   page_id_t page_id = 15445;
   page.Init(page_id, PAGE_SIZE);
@@ -41,11 +37,31 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
 
   Tuple tuple(values, &schema);
   TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
-  page.Insert(tuple, &tmp_tuple);
+  ASSERT_TRUE(page.Insert(tuple, &tmp_tuple));
 
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  ASSERT_EQ(tmp_tuple, TmpTuple(page_id, PAGE_SIZE - 8));
+
+  // fill the page, then read every tuple back, newest first
+  int32_t inserted = 1;
+  while (true) {
+    Tuple next({ValueFactory::GetIntegerValue(123 + inserted)}, &schema);
+    if (!page.Insert(next, &tmp_tuple)) {
+      break;
+    }
+    inserted++;
+  }
+  ASSERT_EQ(inserted, (PAGE_SIZE - 12) / 8);
+  int32_t read = 0;
+  for (uint32_t offset = page.GetFirstOffset(); offset < PAGE_SIZE; offset = page.GetNextOffset(offset)) {
+    Tuple out;
+    page.Get(TmpTuple(page_id, offset), &out);
+    ASSERT_EQ(out.GetValue(&schema, 0).GetAs<int32_t>(), 123 + inserted - 1 - read);
+    read++;
+  }
+  ASSERT_EQ(read, inserted);
 }
 
 }  // namespace bustub